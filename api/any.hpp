@@ -10,6 +10,7 @@
 #include <cstddef>
 #include <cstdlib>
 #include <cstring>
+#include <type_traits>
 #include <ostream>
 
 #include "str.hpp"
@@ -22,13 +23,28 @@ namespace jule
     // Built-in any type.
     class Any;
 
+    // Error slot of exceptionals.
+    class Error;
+
     class Any
     {
     private:
+        friend class jule::Error;
+
+        // Maximum size of data stored in buffer of any instead of heap.
+        static constexpr std::size_t SMALL_SIZE = 16;
+
         template <typename T>
         struct DynamicType
         {
         public:
+            // Trivially copyable small data stored in buffer.
+            // Copied by bytes and not needs destruction.
+            static constexpr jule::Bool small =
+                sizeof(T) <= jule::Any::SMALL_SIZE &&
+                alignof(T) <= alignof(jule::U64) &&
+                std::is_trivially_copyable<T>::value;
+
             static const char *type_id(void) noexcept
             {
                 return typeid(T).name();
@@ -66,6 +82,9 @@ namespace jule
         struct Type
         {
         public:
+            jule::TypeId id;
+            jule::Bool small;
+            std::size_t size;
             const char *(*type_id)(void);
             void (*dealloc)(void *alloc);
             jule::Bool (*eq)(void *alloc, void *other);
@@ -78,6 +97,9 @@ namespace jule
         {
             using type = typename std::decay<DynamicType<T>>::type;
             static jule::Any::Type table = {
+                .id = jule::type_id<T>(),
+                .small = type::small,
+                .size = sizeof(T),
                 .type_id = type::type_id,
                 .dealloc = type::dealloc,
                 .eq = type::eq,
@@ -90,6 +112,8 @@ namespace jule
     public:
         mutable void *data = nullptr;
         mutable jule::Any::Type *type = nullptr;
+        // Buffer of small data, data points to buffer if type is small.
+        alignas(jule::U64) mutable unsigned char buffer[jule::Any::SMALL_SIZE];
 
         Any(void) = default;
         Any(const std::nullptr_t) : Any() {}
@@ -105,10 +129,9 @@ namespace jule
             this->__get_copy(src);
         }
 
-        Any(jule::Any &&src) noexcept : data(src.data), type(src.type)
+        Any(jule::Any &&src) noexcept
         {
-            // Avoid deallocation.
-            src.data = nullptr;
+            this->__move(src);
         }
 
         ~Any(void)
@@ -122,23 +145,67 @@ namespace jule
             if (src == nullptr)
                 return;
 
+            if (src.type->small)
+            {
+                std::memcpy(this->buffer, src.buffer, jule::Any::SMALL_SIZE);
+                this->data = this->buffer;
+                this->type = src.type;
+                return;
+            }
+
             void *new_heap = src.type->alloc_new_copy(src.data);
-            if (!new_heap)
-                jule::panic(__JULE_ERROR__MEMORY_ALLOCATION_FAILED
-                            "\nruntime: memory allocation failed for heap data of type any");
+            if (__JULE_UNLIKELY(!new_heap))
+                jule::panic_error(__JULE_ERROR__MEMORY_ALLOCATION_FAILED
+                                  "\nruntime: memory allocation failed for heap data of type any");
 
             this->data = new_heap;
             this->type = src.type;
         }
 
+        // Move content from source.
+        // Source will be nil.
+        void __move(jule::Any &src) noexcept
+        {
+            if (src == nullptr)
+                return;
+
+            if (src.type->small)
+            {
+                std::memcpy(this->buffer, src.buffer, jule::Any::SMALL_SIZE);
+                this->data = this->buffer;
+            }
+            else
+                this->data = src.data;
+            this->type = src.type;
+            // Avoid deallocation.
+            src.data = nullptr;
+            src.type = nullptr;
+        }
+
         // Assign data.
         template <typename T>
-        void __assign(const T &expr) noexcept
+        inline void __assign(const T &expr) noexcept
+        {
+            this->__assign<T>(expr, std::integral_constant<jule::Bool, jule::Any::DynamicType<T>::small>());
+        }
+
+        // Assign small data to buffer.
+        template <typename T>
+        void __assign(const T &expr, std::true_type) noexcept
+        {
+            std::memcpy(this->buffer, &expr, sizeof(T));
+            this->data = this->buffer;
+            this->type = jule::Any::new_type<T>();
+        }
+
+        // Assign data to heap.
+        template <typename T>
+        void __assign(const T &expr, std::false_type) noexcept
         {
             T *alloc = new (std::nothrow) T;
-            if (!alloc)
-                jule::panic(__JULE_ERROR__MEMORY_ALLOCATION_FAILED
-                            "\nruntime: memory allocation failed for heap data of type any");
+            if (__JULE_UNLIKELY(!alloc))
+                jule::panic_error(__JULE_ERROR__MEMORY_ALLOCATION_FAILED
+                                  "\nruntime: memory allocation failed for heap data of type any");
 
             *alloc = expr;
             this->data = static_cast<void *>(alloc);
@@ -147,7 +214,7 @@ namespace jule
 
         void dealloc(void) noexcept
         {
-            if (this->data)
+            if (this->data && !this->type->small)
                 this->type->dealloc(this->data);
 
             this->type = nullptr;
@@ -160,10 +227,16 @@ namespace jule
             if (std::is_same<typename std::decay<T>::type, std::nullptr_t>::value)
                 return false;
 
-            if (this->operator==(nullptr))
-                return false;
+            return this->type_id() == jule::type_id<T>();
+        }
 
-            return std::strcmp(this->type->type_id(), typeid(T).name()) == 0;
+        // Returns runtime identity of type of data.
+        // Returns nullptr if data is nil.
+        inline jule::TypeId type_id(void) const noexcept
+        {
+            if (this->operator==(nullptr))
+                return nullptr;
+            return this->type->id;
         }
 
         template <typename T>
@@ -192,6 +265,17 @@ namespace jule
             return *this;
         }
 
+        Any& operator=(jule::Any &&src) noexcept
+        {
+            // Assignment to itself.
+            if (this == &src)
+                return *this;
+
+            this->dealloc();
+            this->__move(src);
+            return *this;
+        }
+
         inline Any& operator=(const std::nullptr_t) noexcept
         {
             this->dealloc();
@@ -208,27 +292,19 @@ namespace jule
         ) const noexcept
         {
 #ifndef __JULE_DISABLE__SAFETY
-            if (this->operator==(nullptr))
-            {
+            if (__JULE_UNLIKELY(this->operator==(nullptr)))
+                jule::panic_error(__JULE_ERROR__INVALID_MEMORY "\nruntime: type any casted but data is nil"
 #ifndef __JULE_ENABLE__PRODUCTION
-                std::string error = __JULE_ERROR__INVALID_MEMORY "\nruntime: type any casted but data is nil\nfile: ";
-                error += file;
-                jule::panic(error);
-#else
-                jule::panic(__JULE_ERROR__INVALID_MEMORY "\nruntime: type any casted but data is nil");
+                                  , file
 #endif
-            }
+                );
 
-            if (!this->type_is<T>())
-            {
+            if (__JULE_UNLIKELY(!this->type_is<T>()))
+                jule::panic_error(__JULE_ERROR__INCOMPATIBLE_TYPE "\nruntime: type any casted to incompatible type"
 #ifndef __JULE_ENABLE__PRODUCTION
-                std::string error = __JULE_ERROR__INCOMPATIBLE_TYPE "\nruntime: type any casted to incompatible type\nfile: ";
-                error += file;
-                jule::panic(error);
-#else
-                jule::panic(__JULE_ERROR__INCOMPATIBLE_TYPE "\nruntime: type any casted to incompatible type");
+                                  , file
 #endif
-            }
+                );
 #endif
 
             return *static_cast<T *>(this->data);
@@ -268,7 +344,7 @@ namespace jule
             if (other.operator==(nullptr))
                 return false;
 
-            if (std::strcmp(this->type->type_id(), other.type->type_id()) != 0)
+            if (this->type->id != other.type->id)
                 return false;
 
             return this->type->eq(this->data, other.data);
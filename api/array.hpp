@@ -74,30 +74,24 @@ namespace jule
             const jule::Int &end) const noexcept
         {
 #ifndef __JULE_DISABLE__SAFETY
-            if (start < 0 || end < 0 || start > end || end > N)
-            {
-                std::string error;
-                __JULE_WRITE_ERROR_SLICING_INDEX_OUT_OF_RANGE(error, start, end, N);
-                error += "\nruntime: array slicing with out of range indexes";
+            if (__JULE_UNLIKELY(start < 0 || end < 0 || start > end || end > N))
+                jule::panic_slicing("\nruntime: array slicing with out of range indexes",
+                                    start, end, N
 #ifndef __JULE_ENABLE__PRODUCTION
-                error += "\nfile: ";
-                error += file;
+                                    , file
 #endif
-                jule::panic(error);
-            }
+                );
 #endif
             if (start == end)
                 return jule::Slice<Item>();
 
             jule::Slice<Item> slice;
             slice.alloc_new(0, end - start);
-            slice._len = slice._cap;
 
-            Item *s_it = slice.begin();
             jule::Array<Item, N>::ConstIterator a_it = this->begin() + start;
             jule::Array<Item, N>::ConstIterator a_end = this->begin() + end;
             while (a_it < a_end)
-                *s_it++ = *a_it++;
+                slice.__push(*a_it++);
 
             return slice;
         }
@@ -176,17 +170,13 @@ namespace jule
             const jule::Int &index) const noexcept
         {
 #ifndef __JULE_DISABLE__SAFETY
-            if (this->empty() || index < 0 || N <= index)
-            {
-                std::string error;
-                __JULE_WRITE_ERROR_INDEX_OUT_OF_RANGE(error, index, N);
-                error += "\nruntime: array indexing with out of range index";
+            if (__JULE_UNLIKELY(static_cast<jule::Uint>(index) >= static_cast<jule::Uint>(N)))
+                jule::panic_index("\nruntime: array indexing with out of range index",
+                                  index, N
 #ifndef __JULE_ENABLE__PRODUCTION
-                error += "\nfile: ";
-                error += file;
+                                  , file
 #endif
-                jule::panic(error);
-            }
+                );
 #endif
             return this->__at(index);
         }
@@ -194,20 +184,12 @@ namespace jule
         inline void swap(const jule::Int &i, const jule::Int &j) const noexcept
         {
 #ifndef __JULE_DISABLE__SAFETY
-            if (this->empty() || i < 0 || N <= i)
-            {
-                std::string error;
-                __JULE_WRITE_ERROR_INDEX_OUT_OF_RANGE(error, i, N);
-                error += "\nruntime: array element swapping with out of range index";
-                jule::panic(error);
-            }
-            if (this->empty() || j < 0 || N <= j)
-            {
-                std::string error;
-                __JULE_WRITE_ERROR_INDEX_OUT_OF_RANGE(error, j, N);
-                error += "\nruntime: array element swapping with out of range index";
-                jule::panic(error);
-            }
+            if (__JULE_UNLIKELY(static_cast<jule::Uint>(i) >= static_cast<jule::Uint>(N)))
+                jule::panic_index("\nruntime: array element swapping with out of range index",
+                                  i, N);
+            if (__JULE_UNLIKELY(static_cast<jule::Uint>(j) >= static_cast<jule::Uint>(N)))
+                jule::panic_index("\nruntime: array element swapping with out of range index",
+                                  j, N);
 #endif
             std::swap(this->__at(i), this->__at(j));
         }
@@ -65,18 +65,9 @@ namespace jule
     jule::Slice<Item> alloc_for_append(const jule::Slice<Item> &dest,
                                        const jule::Int &n) noexcept
     {
-        if (dest._len + n > dest._cap)
-        {
-            const jule::Int alloc_size = (dest._len + n) * 2;
-            jule::Slice<Item> buffer = jule::Slice<Item>::alloc(0, alloc_size);
-            buffer._len = dest._len;
-            std::move(
-                dest._slice,
-                dest._slice + dest._len,
-                buffer._slice);
-            return buffer;
-        }
-        return dest;
+        jule::Slice<Item> buffer = dest;
+        buffer.__reserve_append(n);
+        return buffer;
     }
 
     template <typename Item>
@@ -105,15 +96,10 @@ namespace jule
         if (components._len == 0)
             return src;
 
-        if (src._len + components._len > src._cap)
-            src = jule::alloc_for_append(src, components._len);
+        src.__reserve_append(components._len);
 
-        std::copy(
-            components._slice,
-            components._slice + components._len,
-            src._slice + src._len);
-
-        src._len += components._len;
+        for (const Item &item : components)
+            src.__push(item);
         return src;
     }
 
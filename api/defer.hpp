@@ -5,26 +5,32 @@
 #ifndef __JULE_DEFER_HPP
 #define __JULE_DEFER_HPP
 
-#include <functional>
-
 #define __JULE_CCONCAT(A, B) A##B
 #define __JULE_CONCAT(A, B) __JULE_CCONCAT(A, B)
 
-#define __JULE_DEFER(BLOCK) \
-    jule::DeferBase __JULE_CONCAT(__deferred_, __LINE__) { [&] BLOCK }
+// Deferred block is stored as local lambda, guard calls it at end of
+// the enclosing C++ scope. Lambda is declared before guard, so it is
+// destroyed after guard.
+#define __JULE_DEFER(...)                                            \
+    auto __JULE_CONCAT(__deferred_scope_, __LINE__) = [&] __VA_ARGS__; \
+    jule::Defer<decltype(__JULE_CONCAT(__deferred_scope_, __LINE__))> __JULE_CONCAT(__deferred_, __LINE__) { __JULE_CONCAT(__deferred_scope_, __LINE__) }
 
 namespace jule
 {
 
-    struct DeferBase
+    // Scope guard of deferred block.
+    // Calls block directly, without type erasure and allocation.
+    template <typename F>
+    struct Defer
     {
     public:
-        std::function<void(void)> scope;
+        F &scope;
 
-        DeferBase(void) = default;
-        DeferBase(const std::function<void(void)> &fn) : scope(fn) {}
+        Defer(F &scope) noexcept : scope(scope) {}
+        Defer(const jule::Defer<F> &) = delete;
+        jule::Defer<F> &operator=(const jule::Defer<F> &) = delete;
 
-        ~DeferBase(void)
+        ~Defer(void)
         {
             this->scope();
         }
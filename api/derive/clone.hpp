@@ -62,9 +62,8 @@ namespace jule
     jule::Slice<Item> clone(const jule::Slice<Item> &s)
     {
         jule::Slice<Item> s_clone = jule::Slice<Item>::alloc(0, s._len);
-        s_clone._len = s._len;
         for (int i = 0; i < s._len; ++i)
-            s_clone._slice[i] = jule::clone(s._slice[i]);
+            s_clone.__push(jule::clone(s._slice[i]));
         return s_clone;
     }
 
@@ -10,6 +10,7 @@
 #define __JULE_ERROR__MEMORY_ALLOCATION_FAILED "memory allocation failed"
 #define __JULE_ERROR__INDEX_OUT_OF_RANGE "index out of range"
 #define __JULE_ERROR__DIVIDE_BY_ZERO "divide by zero"
+#define __JULE_ERROR__STACK_OVERFLOW "stack overflow"
 
 #define __JULE_WRITE_ERROR_SLICING_INDEX_OUT_OF_RANGE(STR, START, END, LEN) \
     STR += __JULE_ERROR__INDEX_OUT_OF_RANGE " [";                           \
@@ -5,24 +5,224 @@
 #ifndef __JULE_EXCEPTIONAL_HPP
 #define __JULE_EXCEPTIONAL_HPP
 
+#include <new>
 #include <tuple>
+#include <cstring>
+#include <utility>
+#include <type_traits>
 
 #include "any.hpp"
 
 namespace jule
 {
 
+    // Compact error slot of exceptionals, two words.
+    // Type is nullptr if there is no error. Trivially copyable errors which
+    // fit a word, such as enum-style errors, are stored in the word without
+    // allocation. Other errors are boxed as any and word points to the box.
+    // Handlers access error as any, errors in word are boxed lazily then.
+    class Error
+    {
+    private:
+        // Maximum size of error stored in word.
+        static constexpr std::size_t WORD_SIZE = sizeof(jule::U64);
+
+        template <typename T>
+        struct Word
+        {
+        public:
+            static constexpr jule::Bool fits =
+                sizeof(T) <= jule::Error::WORD_SIZE &&
+                alignof(T) <= alignof(jule::U64) &&
+                std::is_trivially_copyable<T>::value;
+        };
+
+        // Type of error in word, jule::Error::boxed_type if boxed.
+        jule::Any::Type *type = nullptr;
+        union
+        {
+            jule::U64 word;
+            jule::Any *boxed;
+        };
+
+        static inline jule::Bool in_word(const jule::Any::Type *type) noexcept
+        {
+            return type->small && type->size <= jule::Error::WORD_SIZE;
+        }
+
+        static jule::Any::Type *boxed_type(void) noexcept
+        {
+            static jule::Any::Type type = {};
+            return &type;
+        }
+
+        inline jule::Bool is_boxed(void) const noexcept
+        {
+            return this->type == jule::Error::boxed_type();
+        }
+
+        // Boxes any, source will be nil.
+        void box(jule::Any &&src) noexcept
+        {
+            this->boxed = new (std::nothrow) jule::Any(std::move(src));
+            if (__JULE_UNLIKELY(!this->boxed))
+                jule::panic_error(__JULE_ERROR__MEMORY_ALLOCATION_FAILED
+                                  "\nruntime: memory allocation failed for error of exceptional");
+            this->type = jule::Error::boxed_type();
+        }
+
+        // Returns error in word as any.
+        jule::Any unword(void) const noexcept
+        {
+            jule::Any error;
+            std::memcpy(error.buffer, &this->word, this->type->size);
+            error.data = error.buffer;
+            error.type = this->type;
+            return error;
+        }
+
+        void set(jule::Any &&src) noexcept
+        {
+            if (src == nullptr)
+                return;
+            if (jule::Error::in_word(src.type))
+            {
+                std::memcpy(&this->word, src.buffer, src.type->size);
+                this->type = src.type;
+            }
+            else
+                this->box(std::move(src));
+        }
+
+        template <typename T>
+        void set(const T &expr, std::true_type) noexcept
+        {
+            std::memcpy(&this->word, &expr, sizeof(T));
+            this->type = jule::Any::new_type<T>();
+        }
+
+        template <typename T>
+        void set(const T &expr, std::false_type) noexcept
+        {
+            this->box(jule::Any(expr));
+        }
+
+        void copy(const jule::Error &src) noexcept
+        {
+            if (src.is_boxed())
+                this->set(jule::Any(*src.boxed));
+            else
+            {
+                this->word = src.word;
+                this->type = src.type;
+            }
+        }
+
+        void dealloc(void) noexcept
+        {
+            if (this->is_boxed())
+                delete this->boxed;
+            this->type = nullptr;
+        }
+
+    public:
+        Error(void) noexcept : word(0) {}
+        Error(const std::nullptr_t) noexcept : Error() {}
+
+        template <typename T>
+        Error(const T &expr) noexcept : Error()
+        {
+            this->set<T>(expr, std::integral_constant<jule::Bool, jule::Error::Word<T>::fits>());
+        }
+
+        Error(const jule::Any &src) noexcept : Error()
+        {
+            this->set(jule::Any(src));
+        }
+
+        Error(jule::Any &&src) noexcept : Error()
+        {
+            this->set(std::move(src));
+        }
+
+        Error(const jule::Error &src) noexcept : Error()
+        {
+            this->copy(src);
+        }
+
+        Error(jule::Error &&src) noexcept : type(src.type), word(src.word)
+        {
+            // Avoid deallocation.
+            src.type = nullptr;
+        }
+
+        ~Error(void) noexcept
+        {
+            this->dealloc();
+        }
+
+        jule::Error &operator=(const jule::Error &src) noexcept
+        {
+            if (this != &src)
+            {
+                this->dealloc();
+                this->copy(src);
+            }
+            return *this;
+        }
+
+        jule::Error &operator=(jule::Error &&src) noexcept
+        {
+            if (this != &src)
+            {
+                this->dealloc();
+                this->type = src.type;
+                this->word = src.word;
+                src.type = nullptr;
+            }
+            return *this;
+        }
+
+        // Returns error as any for handlers, which may also assign it.
+        // Boxes error if stored in word. Error must not be nil.
+        jule::Any &any(void) noexcept
+        {
+            if (!this->is_boxed())
+                this->box(this->unword());
+            return *this->boxed;
+        }
+
+        // Returns string form of error.
+        // Error must not be nil.
+        jule::Str to_str(void) const noexcept
+        {
+            if (!this->is_boxed())
+                return this->type->to_str(&this->word);
+            return this->boxed->type->to_str(this->boxed->data);
+        }
+
+        constexpr jule::Bool operator==(std::nullptr_t) const noexcept
+        {
+            return !this->type;
+        }
+
+        constexpr jule::Bool operator!=(std::nullptr_t) const noexcept
+        {
+            return !this->operator==(nullptr);
+        }
+    };
+
     // Wrapper structure for Jule's void exceptionals.
     class VoidExceptional
     {
     public:
-        jule::Any error;
+        jule::Error error;
 
         VoidExceptional(void) = default;
-        VoidExceptional(const jule::Any &error) : error(error) {}
+        VoidExceptional(jule::Error error) noexcept : error(std::move(error)) {}
 
         // Reports whether no exception.
-        bool ok(void) const noexcept
+        inline bool ok(void) const noexcept
         {
             return this->error == nullptr;
         }
@@ -33,15 +233,16 @@ namespace jule
     class Exceptional
     {
     public:
-        jule::Any error;
+        jule::Error error;
         T result;
 
         Exceptional(void) = default;
-        Exceptional(const jule::Any &error) : error(error) {}
-        Exceptional(const jule::Any &error, const T &result) : error(error), result(result) {}
+        Exceptional(jule::Error error) noexcept : error(std::move(error)) {}
+        Exceptional(jule::Error error, const T &result) : error(std::move(error)), result(result) {}
+        Exceptional(jule::Error error, T &&result) noexcept : error(std::move(error)), result(std::move(result)) {}
 
         // Reports whether no exception.
-        bool ok(void) const noexcept
+        inline bool ok(void) const noexcept
         {
             return this->error == nullptr;
         }
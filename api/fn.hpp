@@ -6,76 +6,176 @@
 #define __JULE_FN_HPP
 
 #include <string>
+#include <atomic>
 #include <cstddef>
-#include <functional>
-#include <thread>
+#include <cstring>
+#include <type_traits>
+#include <utility>
 
 #include "types.hpp"
 #include "error.hpp"
 #include "panic.hpp"
-
-#define __JULE_CO_SPAWN(ROUTINE) \
-    (std::thread{ROUTINE})
-#define __JULE_CO(EXPR) \
-    (__JULE_CO_SPAWN([&](void) mutable -> void { EXPR; }).detach())
+#include "ptr.hpp"
 
 namespace jule
 {
 
-    // std::function wrapper of JuleC.
+    // Function type of JuleC.
+    // Non-capturing functions are called by function pointer directly.
+    // Small trivially copyable closures are stored in buffer of function,
+    // other closures are reference-counted heap allocations shared by copies.
     template <typename>
     struct Fn;
 
-    template <typename T, typename... U>
-    jule::Uintptr addr_of_fn(std::function<T(U...)> f) noexcept;
+    // Base of heap allocated closures.
+    struct FnClosure
+    {
+    };
 
-    template <typename Function>
-    struct Fn
+    // Heap allocated closure.
+    template <typename F>
+    struct FnClosureOf : public jule::FnClosure
     {
     public:
-        std::function<Function> buffer;
-        jule::Uintptr _addr;
+        F f;
+
+        FnClosureOf(F &&f) : f(std::move(f)) {}
+    };
+
+    template <typename R, typename... A>
+    struct Fn<R(A...)>
+    {
+    private:
+        // Maximum size of closure stored in buffer instead of heap.
+        static constexpr std::size_t SMALL_SIZE = 16;
+
+        template <typename F>
+        using Direct = std::integral_constant<
+            jule::Bool,
+            std::is_empty<F>::value && std::is_convertible<F, R (*)(A...)>::value>;
+
+        template <typename F>
+        using Small = std::integral_constant<
+            jule::Bool,
+            sizeof(F) <= SMALL_SIZE &&
+                alignof(F) <= alignof(jule::U64) &&
+                std::is_trivially_copyable<F>::value>;
+
+        // Enabled if F is not function or nil, so F is a closure.
+        template <typename F>
+        using Closure = typename std::enable_if<
+            !std::is_same<typename std::decay<F>::type, jule::Fn<R(A...)>>::value &&
+            !std::is_same<typename std::decay<F>::type, std::nullptr_t>::value>::type;
+
+        template <typename F>
+        static R invoke_small(const jule::Fn<R(A...)> &fn, A... args)
+        {
+            return (*reinterpret_cast<F *>(fn.buffer))(args...);
+        }
+
+        template <typename F>
+        static R invoke_heap(const jule::Fn<R(A...)> &fn, A... args)
+        {
+            return static_cast<jule::FnClosureOf<F> *>(fn.closure.alloc)->f(args...);
+        }
+
+        // Non-capturing function.
+        template <typename F>
+        void __assign(F &&function, std::true_type, jule::Bool) noexcept
+        {
+            this->fn = static_cast<R (*)(A...)>(function);
+            this->_addr = reinterpret_cast<jule::Uintptr>(this->fn);
+        }
+
+        // Closure which is stored in buffer.
+        template <typename F>
+        void __assign(F &&function, std::false_type, std::true_type) noexcept
+        {
+            std::memcpy(this->buffer, static_cast<const void *>(&function), sizeof(F));
+            this->invoke = invoke_small<F>;
+            this->_addr = small_addr();
+        }
+
+        // Returns identity for closure which is stored in buffer.
+        // Buffer moves with function and its address may be reused, so
+        // closures take odd numbers of counter instead. Addresses of
+        // functions and heap closures are aligned, they never collide.
+        static jule::Uintptr small_addr(void) noexcept
+        {
+            static std::atomic<jule::Uintptr> next{0};
+            return (next.fetch_add(1, std::memory_order_relaxed) << 1) | 1;
+        }
+
+        // Closure which is allocated on heap.
+        template <typename F>
+        void __assign(F &&function, std::false_type, std::false_type) noexcept
+        {
+            jule::PtrBlock<jule::FnClosureOf<F>> *block =
+                jule::new_ptr_block<jule::FnClosureOf<F>>(std::move(function));
+            this->closure = jule::Ptr<jule::FnClosure>::make(
+                static_cast<jule::FnClosure *>(&block->value), &block->n);
+            this->invoke = invoke_heap<F>;
+            this->_addr = reinterpret_cast<jule::Uintptr>(&block->value);
+        }
+
+    public:
+        // Function pointer of non-capturing function, nullptr for closures.
+        R (*fn)(A...) = nullptr;
+        // Calls closure, nullptr for non-capturing functions.
+        R (*invoke)(const jule::Fn<R(A...)> &fn, A... args) = nullptr;
+        // Heap allocated closure.
+        jule::Ptr<jule::FnClosure> closure;
+        // Buffer of small closure.
+        alignas(jule::U64) mutable unsigned char buffer[SMALL_SIZE];
+        jule::Uintptr _addr = 0;
 
         Fn(void) = default;
-        Fn(const Fn<Function> &fn) = default;
+        Fn(const jule::Fn<R(A...)> &fn) = default;
         Fn(std::nullptr_t) : Fn() {}
 
-        Fn(const std::function<Function> &function) noexcept
+        Fn(jule::Fn<R(A...)> &&fn) noexcept
+            : fn(fn.fn), invoke(fn.invoke), closure(std::move(fn.closure)), _addr(fn._addr)
         {
-            this->_addr = jule::addr_of_fn(function);
-            if (this->_addr == 0)
-                this->_addr = (jule::Uintptr)(&function);
-            this->buffer = function;
+            std::memcpy(this->buffer, fn.buffer, sizeof(this->buffer));
+            fn.fn = nullptr;
+            fn.invoke = nullptr;
+            fn._addr = 0;
         }
 
-        Fn(const Function *function) noexcept
+        Fn(R (*function)(A...)) noexcept
         {
-            this->buffer = function;
-            this->_addr = jule::addr_of_fn(this->buffer);
-            if (this->_addr == 0)
-                this->_addr = (jule::Uintptr)(function);
+            this->fn = function;
+            this->_addr = reinterpret_cast<jule::Uintptr>(function);
+        }
+
+        template <typename F, typename = Closure<F>>
+        Fn(F function) noexcept
+        {
+            this->__assign<F>(std::move(function), Direct<F>(), Small<F>());
         }
 
         template <typename... Arguments>
-        auto call(
+        inline R call(
 #ifndef __JULE_ENABLE__PRODUCTION
             const char *file,
 #endif
-            Arguments... arguments)
+            Arguments... arguments) const
         {
+            if (__JULE_LIKELY(this->fn != nullptr))
+                return this->fn(arguments...);
 #ifndef __JULE_DISABLE__SAFETY
-            if (this->buffer == nullptr)
+            if (__JULE_UNLIKELY(this->invoke == nullptr))
+                jule::panic_error(__JULE_ERROR__INVALID_MEMORY
 #ifndef __JULE_ENABLE__PRODUCTION
-                jule::panic((std::string(__JULE_ERROR__INVALID_MEMORY) + "\nfile: ") + file);
-#else
-                jule::panic(__JULE_ERROR__INVALID_MEMORY);
-#endif // PRODUCTION
+                                  , file
+#endif
+                );
 #endif // SAFETY
-            return this->buffer(arguments...);
+            return this->invoke(*this, arguments...);
         }
 
         template <typename... Arguments>
-        inline auto operator()(Arguments... arguments)
+        inline R operator()(Arguments... arguments) const
         {
 #ifndef __JULE_ENABLE__PRODUCTION
             return this->call<Arguments...>("/api/fn.hpp", arguments...);
@@ -89,37 +189,53 @@ namespace jule
             return this->_addr;
         }
 
-        inline Fn<Function>& operator=(std::nullptr_t) noexcept
+        jule::Fn<R(A...)> &operator=(const jule::Fn<R(A...)> &fn) = default;
+
+        jule::Fn<R(A...)> &operator=(jule::Fn<R(A...)> &&fn) noexcept
         {
-            this->buffer = nullptr;
+            // Assignment to itself.
+            if (this == &fn)
+                return *this;
+
+            this->fn = fn.fn;
+            this->invoke = fn.invoke;
+            this->closure = std::move(fn.closure);
+            std::memcpy(this->buffer, fn.buffer, sizeof(this->buffer));
+            this->_addr = fn._addr;
+            fn.fn = nullptr;
+            fn.invoke = nullptr;
+            fn._addr = 0;
             return *this;
         }
 
-        inline Fn<Function>& operator=(const std::function<Function> &function)
+        inline jule::Fn<R(A...)> &operator=(std::nullptr_t) noexcept
         {
-            this->buffer = function;
+            this->fn = nullptr;
+            this->invoke = nullptr;
+            this->closure = nullptr;
+            this->_addr = 0;
             return *this;
         }
 
-        inline Fn<Function>& operator=(const Function &function)
+        template <typename F, typename = Closure<F>>
+        inline jule::Fn<R(A...)> &operator=(F function) noexcept
         {
-            this->buffer = function;
-            return *this;
+            return this->operator=(jule::Fn<R(A...)>(std::move(function)));
         }
 
-        constexpr jule::Bool operator==(const Fn<Function> &fn) const noexcept
+        constexpr jule::Bool operator==(const jule::Fn<R(A...)> &fn) const noexcept
         {
             return this->addr() == fn.addr();
         }
 
-        constexpr jule::Bool operator!=(const Fn<Function> &fn) const noexcept
+        constexpr jule::Bool operator!=(const jule::Fn<R(A...)> &fn) const noexcept
         {
             return !this->operator==(fn);
         }
 
         constexpr jule::Bool operator==(std::nullptr_t) const noexcept
         {
-            return this->buffer == nullptr;
+            return this->fn == nullptr && this->invoke == nullptr;
         }
 
         constexpr jule::Bool operator!=(std::nullptr_t) const noexcept
@@ -128,22 +244,12 @@ namespace jule
         }
 
         friend std::ostream &operator<<(std::ostream &stream,
-                                        const Fn<Function> &src) noexcept
+                                        const jule::Fn<R(A...)> &src) noexcept
         {
             return (stream << (void *)src._addr);
         }
     };
 
-    template <typename T, typename... U>
-    jule::Uintptr addr_of_fn(std::function<T(U...)> f) noexcept
-    {
-        typedef T(FnType)(U...);
-        FnType **fn_ptr = f.template target<FnType *>();
-        if (!fn_ptr)
-            return 0;
-        return (jule::Uintptr)(*fn_ptr);
-    }
-
 } // namespace jule
 
 #endif // ifndef __JULE_FN_HPP
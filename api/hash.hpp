@@ -0,0 +1,217 @@
+// Copyright 2024 The Jule Programming Language.
+// Use of this source code is governed by a BSD 3-Clause
+// license that can be found in the LICENSE file.
+
+#ifndef __JULE_HASH_HPP
+#define __JULE_HASH_HPP
+
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+#include "types.hpp"
+#include "str.hpp"
+#include "slice.hpp"
+#include "array.hpp"
+#include "ptr.hpp"
+#include "trait.hpp"
+#include "fn.hpp"
+
+// Type-specialized hashing for built-in map keys.
+//
+// Every key kind hashes by the same notion of identity its equality
+// operator uses, so keys that compare equal always hash equal:
+//  - integers, enums and booleans hash their value
+//  - floats hash their bits, with -0 normalized to +0
+//  - raw pointers, references, traits and functions hash their address
+//  - strings, slices and arrays hash their elements
+//  - generated structures hash their fields through __hash member
+//
+// Remaining types fall back to hashing their string representation.
+namespace jule
+{
+
+    constexpr std::size_t HASH_SEED = static_cast<std::size_t>(0x9E3779B97F4A7C15ULL);
+
+    // Finalizes hash value. Avalanches all bits of input, so consecutive
+    // integers are spread over table slots and control bytes.
+    inline std::size_t hash_mix(jule::U64 x) noexcept;
+
+    // Combines hash of next element into hash of sequence.
+    inline std::size_t hash_combine(const std::size_t seed, const std::size_t hash) noexcept;
+
+    // Returns hash of size bytes starting at data.
+    inline std::size_t hash_bytes(const void *data, const std::size_t size) noexcept;
+
+    inline std::size_t hash(const jule::Str &obj) noexcept;
+
+    template <typename Item>
+    inline std::size_t hash(const jule::Slice<Item> &obj) noexcept;
+
+    template <typename Item, jule::Int N>
+    inline std::size_t hash(const jule::Array<Item, N> &obj) noexcept;
+
+    template <typename T>
+    inline std::size_t hash(const jule::Ptr<T> &obj) noexcept;
+
+    template <typename Mask>
+    inline std::size_t hash(const jule::Trait<Mask> &obj) noexcept;
+
+    template <typename Function>
+    inline std::size_t hash(const jule::Fn<Function> &obj) noexcept;
+
+    template <typename T>
+    inline std::size_t hash(const T &obj) noexcept;
+
+    inline std::size_t hash_mix(jule::U64 x) noexcept
+    {
+        // Finalizer of splitmix64.
+        x ^= x >> 30;
+        x *= 0xBF58476D1CE4E5B9ULL;
+        x ^= x >> 27;
+        x *= 0x94D049BB133111EBULL;
+        x ^= x >> 31;
+        return static_cast<std::size_t>(x);
+    }
+
+    inline std::size_t hash_combine(const std::size_t seed, const std::size_t hash) noexcept
+    {
+        return jule::hash_mix(static_cast<jule::U64>(seed) * 31 + hash);
+    }
+
+    inline std::size_t hash_bytes(const void *data, const std::size_t size) noexcept
+    {
+        constexpr jule::U64 prime = 0x100000001B3ULL;
+        const jule::U8 *bytes = static_cast<const jule::U8 *>(data);
+        jule::U64 hash = jule::HASH_SEED ^ (size * prime);
+        std::size_t n = size;
+        // Consume input in 8-byte words.
+        while (n >= sizeof(jule::U64))
+        {
+            jule::U64 word;
+            std::memcpy(&word, bytes, sizeof(jule::U64));
+            hash = (hash ^ jule::hash_mix(word)) * prime;
+            bytes += sizeof(jule::U64);
+            n -= sizeof(jule::U64);
+        }
+        // Remaining tail bytes.
+        if (n > 0)
+        {
+            jule::U64 word = 0;
+            std::memcpy(&word, bytes, n);
+            hash = (hash ^ jule::hash_mix(word)) * prime;
+        }
+        return jule::hash_mix(hash);
+    }
+
+    namespace hash_impl
+    {
+
+        // Overload ranking of hash dispatch. Higher rank is tried first.
+        template <int N>
+        struct Rank : Rank<N - 1>
+        {
+        };
+
+        template <>
+        struct Rank<0>
+        {
+        };
+
+        // Generated structures.
+        template <typename T>
+        inline auto of(const T &obj, jule::hash_impl::Rank<3>) noexcept
+            -> decltype(static_cast<std::size_t>(obj.__hash()))
+        {
+            return obj.__hash();
+        }
+
+        // Integers, booleans and enums.
+        template <typename T,
+                  typename std::enable_if<std::is_integral<T>::value ||
+                                              std::is_enum<T>::value,
+                                          int>::type = 0>
+        inline std::size_t of(const T &obj, jule::hash_impl::Rank<2>) noexcept
+        {
+            return jule::hash_mix(static_cast<jule::U64>(obj));
+        }
+
+        // Floating-point numbers.
+        template <typename T,
+                  typename std::enable_if<std::is_floating_point<T>::value,
+                                          int>::type = 0>
+        inline std::size_t of(const T &obj, jule::hash_impl::Rank<2>) noexcept
+        {
+            // Positive and negative zero are equal, hash them same.
+            if (obj == 0)
+                return jule::hash_mix(0);
+            return jule::hash_bytes(&obj, sizeof(T));
+        }
+
+        // Raw pointers.
+        template <typename T>
+        inline std::size_t of(T *const &obj, jule::hash_impl::Rank<2>) noexcept
+        {
+            return jule::hash_mix(reinterpret_cast<jule::Uintptr>(obj));
+        }
+
+        // Fallback: string representation.
+        template <typename T>
+        inline std::size_t of(const T &obj, jule::hash_impl::Rank<0>) noexcept
+        {
+            const jule::Str str = jule::to_str<T>(obj);
+            return jule::hash_bytes(str.buffer.data(), str.buffer.size());
+        }
+
+    } // namespace hash_impl
+
+    inline std::size_t hash(const jule::Str &obj) noexcept
+    {
+        return jule::hash_bytes(obj.buffer.data(), obj.buffer.size());
+    }
+
+    template <typename Item>
+    inline std::size_t hash(const jule::Slice<Item> &obj) noexcept
+    {
+        std::size_t hash = jule::HASH_SEED;
+        for (const Item &item : obj)
+            hash = jule::hash_combine(hash, jule::hash(item));
+        return hash;
+    }
+
+    template <typename Item, jule::Int N>
+    inline std::size_t hash(const jule::Array<Item, N> &obj) noexcept
+    {
+        std::size_t hash = jule::HASH_SEED;
+        for (const Item &item : obj)
+            hash = jule::hash_combine(hash, jule::hash(item));
+        return hash;
+    }
+
+    template <typename T>
+    inline std::size_t hash(const jule::Ptr<T> &obj) noexcept
+    {
+        return jule::hash_mix(reinterpret_cast<jule::Uintptr>(obj.alloc));
+    }
+
+    template <typename Mask>
+    inline std::size_t hash(const jule::Trait<Mask> &obj) noexcept
+    {
+        return jule::hash_mix(reinterpret_cast<jule::Uintptr>(obj.data.alloc));
+    }
+
+    template <typename Function>
+    inline std::size_t hash(const jule::Fn<Function> &obj) noexcept
+    {
+        return jule::hash_mix(static_cast<jule::U64>(obj.addr()));
+    }
+
+    template <typename T>
+    inline std::size_t hash(const T &obj) noexcept
+    {
+        return jule::hash_impl::of(obj, jule::hash_impl::Rank<3>());
+    }
+
+} // namespace jule
+
+#endif // ifndef __JULE_HASH_HPP
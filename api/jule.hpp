@@ -9,7 +9,20 @@ CONFIGURATION DEFINES
 - __JULE_ENABLE__PRODUCTION
 
 - __JULE_DISABLE__REFERENCE_COUNTING
+- __JULE_DISABLE__ATOMIC_REFERENCE_COUNTING
+- __JULE_ENABLE__BIASED_REFERENCE_COUNTING
 - __JULE_DISABLE__SAFETY
+- __JULE_DISABLE__GREEN_THREADS: run concurrent calls on stacks of workers
+
+- __JULE_SLICE_GROWTH: growth of slice capacity in percent, 200 by default
+- __JULE_SLICE_LARGE_GROWTH: growth for large slices in percent, 150 by default
+- __JULE_SLICE_LARGE_THRESHOLD: bytes of large slices, (1 << 20) by default
+
+ENVIRONMENT VARIABLES
+
+- JULE_MAX_PROCS: count of worker threads of concurrent calls,
+  hardware concurrency by default
+- JULE_STACK_SIZE: stack size of green threads in bytes, 8 MiB by default
 
 */
 
@@ -27,11 +40,13 @@ CONFIGURATION DEFINES
 #include "error.hpp"
 #include "exceptional.hpp"
 #include "fn.hpp"
+#include "hash.hpp"
 #include "map.hpp"
 #include "misc.hpp"
 #include "panic.hpp"
 #include "platform.hpp"
 #include "ptr.hpp"
+#include "sched.hpp"
 #include "slice.hpp"
 #include "str.hpp"
 #include "trait.hpp"
@@ -5,19 +5,41 @@
 #ifndef __JULE_MAP_HPP
 #define __JULE_MAP_HPP
 
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <initializer_list>
+#include <new>
 #include <ostream>
-#include <unordered_map>
+#include <utility>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 #include "types.hpp"
+#include "error.hpp"
+#include "panic.hpp"
+#include "ptr.hpp"
 #include "str.hpp"
 #include "slice.hpp"
+#include "hash.hpp"
 
 namespace jule
 {
 
     class MapKeyHasher;
 
+    // Set of slot indexes of a group, as bits.
+    class MapBitMask;
+
+    // Control bytes of a group of consecutive table slots.
+    struct MapGroup;
+
+    // Flat open-addressing hash table of built-in map type.
+    template <typename Key, typename Value>
+    class MapTable;
+
     // Built-in map type.
     template <typename Key, typename Value>
     class Map;
@@ -25,18 +47,565 @@ namespace jule
     class MapKeyHasher
     {
     public:
-        size_t operator()(const jule::Str &key) const
+        template <typename T>
+        inline size_t operator()(const T &obj) const noexcept
         {
-            size_t hash = 0;
-            for (jule::Int i = 0; i < key.len(); ++i)
-                hash += key.buffer[i] % 7;
-            return hash;
+            return jule::hash(obj);
         }
+    };
 
-        template <typename T>
-        inline size_t operator()(const T &obj) const
+    // Control byte states of table slots.
+    // Full slots store 7-bit fragment of the hash of key, high bit is clear.
+    // Empty and deleted slots have the high bit set.
+    constexpr jule::I8 MAP_CTRL_EMPTY = -128;  // 0b10000000
+    constexpr jule::I8 MAP_CTRL_DELETED = -2;  // 0b11111110
+
+#if defined(__SSE2__)
+    class MapBitMask
+    {
+    public:
+        // Bit per slot.
+        static constexpr int SHIFT = 0;
+
+        jule::U32 mask;
+
+        explicit MapBitMask(const jule::U32 mask) noexcept : mask(mask) {}
+
+        inline explicit operator bool(void) const noexcept
+        {
+            return this->mask != 0;
+        }
+
+        // Returns index of lowest slot in the set.
+        inline std::size_t lowest(void) const noexcept
+        {
+            return static_cast<std::size_t>(__builtin_ctz(this->mask));
+        }
+
+        // Removes lowest slot from the set.
+        inline void next(void) noexcept
+        {
+            this->mask &= this->mask - 1;
+        }
+    };
+
+    struct MapGroup
+    {
+        static constexpr std::size_t WIDTH = 16;
+
+        __m128i ctrl;
+
+        explicit MapGroup(const jule::I8 *pos) noexcept
+            : ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i *>(pos))) {}
+
+        // Returns slots with the hash fragment.
+        inline jule::MapBitMask match(const jule::I8 h2) const noexcept
+        {
+            const __m128i match = _mm_set1_epi8(h2);
+            return jule::MapBitMask(static_cast<jule::U32>(
+                _mm_movemask_epi8(_mm_cmpeq_epi8(match, this->ctrl))));
+        }
+
+        // Returns empty slots.
+        inline jule::MapBitMask match_empty(void) const noexcept
+        {
+            const __m128i match = _mm_set1_epi8(jule::MAP_CTRL_EMPTY);
+            return jule::MapBitMask(static_cast<jule::U32>(
+                _mm_movemask_epi8(_mm_cmpeq_epi8(match, this->ctrl))));
+        }
+
+        // Returns empty and deleted slots.
+        inline jule::MapBitMask match_empty_or_deleted(void) const noexcept
+        {
+            return jule::MapBitMask(static_cast<jule::U32>(
+                _mm_movemask_epi8(this->ctrl)));
+        }
+    };
+#else
+    class MapBitMask
+    {
+    public:
+        // High bit of each byte.
+        static constexpr int SHIFT = 3;
+
+        jule::U64 mask;
+
+        explicit MapBitMask(const jule::U64 mask) noexcept : mask(mask) {}
+
+        inline explicit operator bool(void) const noexcept
+        {
+            return this->mask != 0;
+        }
+
+        // Returns index of lowest slot in the set.
+        inline std::size_t lowest(void) const noexcept
+        {
+            return static_cast<std::size_t>(__builtin_ctzll(this->mask)) >> jule::MapBitMask::SHIFT;
+        }
+
+        // Removes lowest slot from the set.
+        inline void next(void) noexcept
+        {
+            this->mask &= this->mask - 1;
+        }
+    };
+
+    // Portable group, control bytes are processed as a single word.
+    struct MapGroup
+    {
+        static constexpr std::size_t WIDTH = 8;
+        static constexpr jule::U64 LSBS = 0x0101010101010101ULL;
+        static constexpr jule::U64 MSBS = 0x8080808080808080ULL;
+
+        jule::U64 ctrl;
+
+        explicit MapGroup(const jule::I8 *pos) noexcept
+        {
+            std::memcpy(&this->ctrl, pos, sizeof(jule::U64));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+            this->ctrl = __builtin_bswap64(this->ctrl);
+#endif
+        }
+
+        // Returns slots with the hash fragment.
+        // May report false positives for full slots,
+        // caller compares keys of matched slots anyway.
+        inline jule::MapBitMask match(const jule::I8 h2) const noexcept
+        {
+            const jule::U64 x = this->ctrl ^ (jule::MapGroup::LSBS * static_cast<jule::U8>(h2));
+            return jule::MapBitMask((x - jule::MapGroup::LSBS) & ~x & jule::MapGroup::MSBS);
+        }
+
+        // Returns empty slots.
+        inline jule::MapBitMask match_empty(void) const noexcept
+        {
+            return jule::MapBitMask((this->ctrl & ~(this->ctrl << 6)) & jule::MapGroup::MSBS);
+        }
+
+        // Returns empty and deleted slots.
+        inline jule::MapBitMask match_empty_or_deleted(void) const noexcept
+        {
+            return jule::MapBitMask(this->ctrl & jule::MapGroup::MSBS);
+        }
+    };
+#endif
+
+    template <typename Key, typename Value>
+    class MapTable
+    {
+    public:
+        using Entry = std::pair<Key, Value>;
+
+        // Slot index of missing keys.
+        static constexpr std::size_t NPOS = static_cast<std::size_t>(-1);
+
+        // Slots are kept up to 7/8 full.
+        static constexpr std::size_t max_len(const std::size_t cap) noexcept
+        {
+            return cap - cap / 8;
+        }
+
+        // Returns H1 part of the hash: selects the probe sequence.
+        static constexpr std::size_t h1(const std::size_t hash) noexcept
+        {
+            return hash >> 7;
+        }
+
+        // Returns H2 part of the hash: stored in the control byte.
+        static constexpr jule::I8 h2(const std::size_t hash) noexcept
+        {
+            return static_cast<jule::I8>(hash & 0x7F);
+        }
+
+        // Control bytes of slots. Followed by copy of first group, so group
+        // loads near the end of the table do not have to wrap around.
+        jule::I8 *ctrl = nullptr;
+        Entry *slots = nullptr;
+
+        // Count of slots. Zero or a power of two not less than group width.
+        std::size_t cap = 0;
+        std::size_t size = 0;
+
+        // Count of empty slots that can be filled before the table grows.
+        // Deleted slots are not counted, they are recycled by a rehash.
+        std::size_t growth_left = 0;
+
+        // Count of ranges which hold table, see jule::Map::Hold.
+        // Not swapped or moved with entries, it belongs to allocation.
+        mutable jule::Uint holds = 0;
+
+        class Iterator
+        {
+        public:
+            const jule::MapTable<Key, Value> *table;
+            std::size_t index;
+
+            Iterator(const jule::MapTable<Key, Value> *table,
+                     const std::size_t index) noexcept
+                : table(table), index(index)
+            {
+                this->skip();
+            }
+
+            // Moves to the first full slot at or after index.
+            // Past the last slot, index becomes NPOS. Iterator does not own
+            // table, ranges keep table alive by jule::Map::Hold.
+            inline void skip(void) noexcept
+            {
+                while (this->index < this->table->cap && this->table->ctrl[this->index] < 0)
+                    ++this->index;
+                if (this->index >= this->table->cap)
+                    this->index = jule::MapTable<Key, Value>::NPOS;
+            }
+
+            inline Entry &operator*(void) const noexcept
+            {
+                return this->table->slots[this->index];
+            }
+
+            inline Entry *operator->(void) const noexcept
+            {
+                return this->table->slots + this->index;
+            }
+
+            inline Iterator &operator++(void) noexcept
+            {
+                ++this->index;
+                this->skip();
+                return *this;
+            }
+
+            inline jule::Bool operator==(const Iterator &it) const noexcept
+            {
+                return this->index == it.index;
+            }
+
+            inline jule::Bool operator!=(const Iterator &it) const noexcept
+            {
+                return this->index != it.index;
+            }
+        };
+
+        MapTable(void) = default;
+
+        MapTable(const jule::MapTable<Key, Value> &src)
+        {
+            this->reserve(src.size);
+            for (const Entry &entry : src)
+                this->insert(entry.first, entry.second);
+        }
+
+        MapTable(jule::MapTable<Key, Value> &&src) noexcept
+            : ctrl(src.ctrl), slots(src.slots),
+              cap(src.cap), size(src.size), growth_left(src.growth_left)
+        {
+            src.ctrl = nullptr;
+            src.slots = nullptr;
+            src.cap = 0;
+            src.size = 0;
+            src.growth_left = 0;
+        }
+
+        ~MapTable(void) noexcept
+        {
+            this->dealloc();
+        }
+
+        jule::MapTable<Key, Value> &operator=(const jule::MapTable<Key, Value> &src)
+        {
+            if (this != &src)
+            {
+                jule::MapTable<Key, Value> copy(src);
+                this->swap(copy);
+            }
+            return *this;
+        }
+
+        jule::MapTable<Key, Value> &operator=(jule::MapTable<Key, Value> &&src) noexcept
+        {
+            this->swap(src);
+            return *this;
+        }
+
+        inline void swap(jule::MapTable<Key, Value> &src) noexcept
+        {
+            std::swap(this->ctrl, src.ctrl);
+            std::swap(this->slots, src.slots);
+            std::swap(this->cap, src.cap);
+            std::swap(this->size, src.size);
+            std::swap(this->growth_left, src.growth_left);
+        }
+
+        inline Iterator begin(void) const noexcept
+        {
+            return Iterator(this, 0);
+        }
+
+        inline void hold(void) const noexcept
+        {
+#ifdef __JULE_DISABLE__ATOMIC_REFERENCE_COUNTING
+            ++this->holds;
+#else
+            __jule_atomic_add_explicit(&this->holds, 1, __JULE_ATOMIC_MEMORY_ORDER__RELAXED);
+#endif
+        }
+
+        inline void release(void) const noexcept
+        {
+#ifdef __JULE_DISABLE__ATOMIC_REFERENCE_COUNTING
+            --this->holds;
+#else
+            __jule_atomic_add_explicit(&this->holds, -1, __JULE_ATOMIC_MEMORY_ORDER__RELAXED);
+#endif
+        }
+
+        inline jule::Uint held(void) const noexcept
+        {
+#ifdef __JULE_DISABLE__ATOMIC_REFERENCE_COUNTING
+            return this->holds;
+#else
+            return __jule_atomic_load_explicit(&this->holds, __JULE_ATOMIC_MEMORY_ORDER__RELAXED);
+#endif
+        }
+
+        inline Iterator end(void) const noexcept
+        {
+            return Iterator(this, jule::MapTable<Key, Value>::NPOS);
+        }
+
+        // Destroys all entries and releases memory.
+        void dealloc(void) noexcept
+        {
+            if (!this->slots)
+                return;
+            this->destroy_entries();
+            ::operator delete(this->slots);
+            this->ctrl = nullptr;
+            this->slots = nullptr;
+            this->cap = 0;
+            this->size = 0;
+            this->growth_left = 0;
+        }
+
+        // Destroys all entries but keeps memory for reuse.
+        void clear(void) noexcept
+        {
+            if (this->size == 0)
+                return;
+            this->destroy_entries();
+            std::memset(this->ctrl, jule::MAP_CTRL_EMPTY, this->cap + jule::MapGroup::WIDTH);
+            this->size = 0;
+            this->growth_left = jule::MapTable<Key, Value>::max_len(this->cap);
+        }
+
+        // Returns slot index of key, or NPOS if key is not exist.
+        std::size_t find(const Key &key) const noexcept
+        {
+            if (this->size == 0)
+                return jule::MapTable<Key, Value>::NPOS;
+            const std::size_t hash = jule::MapKeyHasher()(key);
+            const jule::I8 h2 = jule::MapTable<Key, Value>::h2(hash);
+            const std::size_t mask = this->cap - 1;
+            std::size_t offset = jule::MapTable<Key, Value>::h1(hash) & mask;
+            std::size_t step = 0;
+            for (;;)
+            {
+                const jule::MapGroup group(this->ctrl + offset);
+                for (jule::MapBitMask match = group.match(h2); match; match.next())
+                {
+                    const std::size_t index = (offset + match.lowest()) & mask;
+                    if (this->slots[index].first == key)
+                        return index;
+                }
+                if (group.match_empty())
+                    return jule::MapTable<Key, Value>::NPOS;
+                // Triangular probing visits every group of power-of-two table.
+                step += jule::MapGroup::WIDTH;
+                offset = (offset + step) & mask;
+            }
+        }
+
+        // Returns slot index of key. Inserts default value for key
+        // if key is not exist.
+        std::size_t find_or_insert(const Key &key)
+        {
+            std::size_t index = this->find(key);
+            if (index != jule::MapTable<Key, Value>::NPOS)
+                return index;
+            index = this->prepare_insert(key);
+            new (this->slots + index) Entry(key, Value());
+            return index;
+        }
+
+        // Sets value of key, inserts key if not exist.
+        void insert(const Key &key, Value value)
+        {
+            std::size_t index = this->find(key);
+            if (index != jule::MapTable<Key, Value>::NPOS)
+            {
+                this->slots[index].second = std::move(value);
+                return;
+            }
+            index = this->prepare_insert(key);
+            new (this->slots + index) Entry(key, std::move(value));
+        }
+
+        // Removes entry at slot index.
+        // Removed slot becomes a tombstone, so entries and iterators
+        // of other slots stay valid.
+        void erase(const std::size_t index) noexcept
+        {
+            this->slots[index].~Entry();
+            this->set_ctrl(index, jule::MAP_CTRL_DELETED);
+            --this->size;
+        }
+
+        // Makes room for n entries without growing.
+        void reserve(const std::size_t n)
+        {
+            if (n <= this->size + this->growth_left)
+                return;
+            this->resize(jule::MapTable<Key, Value>::cap_for(n));
+        }
+
+        // Reallocates table to smallest capacity that can hold entries.
+        // Frees memory of table if there is no entry.
+        void shrink(void)
+        {
+            if (this->size == 0)
+            {
+                this->dealloc();
+                return;
+            }
+            const std::size_t cap = jule::MapTable<Key, Value>::cap_for(this->size);
+            if (cap < this->cap)
+                this->resize(cap);
+        }
+
+    private:
+        // Returns maximum capacity which size of allocation can represent.
+        static constexpr std::size_t max_cap(void) noexcept
+        {
+            return (SIZE_MAX - jule::MapGroup::WIDTH) / (sizeof(Entry) + 1);
+        }
+
+        // Panics for capacity which cannot be allocated.
+        static void overflow(void) noexcept
+        {
+            jule::panic_error(__JULE_ERROR__MEMORY_ALLOCATION_FAILED
+                              "\nruntime: map capacity is too large");
+        }
+
+        // Returns smallest capacity that can hold n entries.
+        // Panics if capacity exceeds jule::MapTable::max_cap.
+        static std::size_t cap_for(const std::size_t n) noexcept
+        {
+            constexpr std::size_t max_cap = jule::MapTable<Key, Value>::max_cap();
+            std::size_t cap = jule::MapGroup::WIDTH;
+            while (jule::MapTable<Key, Value>::max_len(cap) < n)
+            {
+                if (__JULE_UNLIKELY(cap > max_cap / 2))
+                    jule::MapTable<Key, Value>::overflow();
+                cap <<= 1;
+            }
+            return cap;
+        }
+
+        inline void set_ctrl(const std::size_t index, const jule::I8 h) noexcept
+        {
+            this->ctrl[index] = h;
+            // Keep copy of the first group in sync.
+            if (index < jule::MapGroup::WIDTH)
+                this->ctrl[this->cap + index] = h;
+        }
+
+        void destroy_entries(void) noexcept
+        {
+            for (std::size_t i = 0; i < this->cap; ++i)
+            {
+                if (this->ctrl[i] >= 0)
+                    this->slots[i].~Entry();
+            }
+        }
+
+        // Returns first empty or deleted slot in probe sequence of hash.
+        std::size_t find_non_full(const std::size_t hash) const noexcept
+        {
+            const std::size_t mask = this->cap - 1;
+            std::size_t offset = jule::MapTable<Key, Value>::h1(hash) & mask;
+            std::size_t step = 0;
+            for (;;)
+            {
+                const jule::MapGroup group(this->ctrl + offset);
+                const jule::MapBitMask match = group.match_empty_or_deleted();
+                if (match)
+                    return (offset + match.lowest()) & mask;
+                step += jule::MapGroup::WIDTH;
+                offset = (offset + step) & mask;
+            }
+        }
+
+        // Claims a slot for missing key and returns its index.
+        // Slot is not constructed.
+        std::size_t prepare_insert(const Key &key)
+        {
+            const std::size_t hash = jule::MapKeyHasher()(key);
+            if (this->cap == 0)
+                this->resize(jule::MapGroup::WIDTH);
+            std::size_t index = this->find_non_full(hash);
+            if (this->growth_left == 0 && this->ctrl[index] != jule::MAP_CTRL_DELETED)
+            {
+                // Mostly tombstones, rehash in place to drop them.
+                // Otherwise the table is full, grow.
+                if (this->size <= jule::MapTable<Key, Value>::max_len(this->cap) / 2)
+                    this->resize(this->cap);
+                else
+                    this->resize(this->cap << 1);
+                index = this->find_non_full(hash);
+            }
+            if (this->ctrl[index] == jule::MAP_CTRL_EMPTY)
+                --this->growth_left;
+            this->set_ctrl(index, jule::MapTable<Key, Value>::h2(hash));
+            ++this->size;
+            return index;
+        }
+
+        void resize(const std::size_t cap)
         {
-            return this->operator()(jule::to_str<T>(obj));
+            constexpr std::size_t max_cap = jule::MapTable<Key, Value>::max_cap();
+            if (__JULE_UNLIKELY(cap > max_cap))
+                jule::MapTable<Key, Value>::overflow();
+            const std::size_t slots_size = cap * sizeof(Entry);
+            void *alloc = ::operator new(slots_size + cap + jule::MapGroup::WIDTH, std::nothrow);
+            if (__JULE_UNLIKELY(!alloc))
+                jule::panic_error(__JULE_ERROR__MEMORY_ALLOCATION_FAILED
+                                  "\nruntime: memory allocation failed for map");
+
+            jule::I8 *old_ctrl = this->ctrl;
+            Entry *old_slots = this->slots;
+            const std::size_t old_cap = this->cap;
+
+            this->slots = static_cast<Entry *>(alloc);
+            this->ctrl = reinterpret_cast<jule::I8 *>(static_cast<jule::U8 *>(alloc) + slots_size);
+            this->cap = cap;
+            this->growth_left = jule::MapTable<Key, Value>::max_len(cap) - this->size;
+            std::memset(this->ctrl, jule::MAP_CTRL_EMPTY, cap + jule::MapGroup::WIDTH);
+
+            if (!old_slots)
+                return;
+
+            for (std::size_t i = 0; i < old_cap; ++i)
+            {
+                if (old_ctrl[i] < 0)
+                    continue;
+                Entry &entry = old_slots[i];
+                const std::size_t hash = jule::MapKeyHasher()(entry.first);
+                const std::size_t index = this->find_non_full(hash);
+                this->set_ctrl(index, jule::MapTable<Key, Value>::h2(hash));
+                new (this->slots + index) Entry(std::move(entry));
+                entry.~Entry();
+            }
+            ::operator delete(old_slots);
         }
     };
 
@@ -44,93 +613,283 @@ namespace jule
     class Map
     {
     public:
-        mutable std::unordered_map<Key, Value, MapKeyHasher> buffer;
+        using Table = jule::MapTable<Key, Value>;
+        using Iterator = typename jule::MapTable<Key, Value>::Iterator;
+
+        // Shared table of entries, nil for empty maps that never allocated.
+        // Copies of map share the table, it is copied at first write
+        // to a shared table.
+        mutable jule::Ptr<Table> data;
+
+        // Keeps table alive while map is ranged by reference.
+        // Iterators point into table, writes in body may detach map from
+        // table and drop its other copies. Hold references table like a
+        // copy, but writes do not count it as other owner of table, so
+        // updating values while ranging does not copy table.
+        class Hold
+        {
+        public:
+            jule::Ptr<Table> data;
+
+            explicit Hold(const jule::Ptr<Table> &data) noexcept : data(data)
+            {
+                if (this->data != nullptr)
+                    this->data.alloc->hold();
+            }
+
+            Hold(const Hold &) = delete;
+            Hold(Hold &&src) noexcept : data(std::move(src.data)) {}
+
+            ~Hold(void) noexcept
+            {
+                if (this->data != nullptr)
+                    this->data.alloc->release();
+            }
+
+            inline Iterator begin(void) const noexcept
+            {
+                return this->table().begin();
+            }
+
+            inline Iterator end(void) const noexcept
+            {
+                return this->table().end();
+            }
+
+        private:
+            inline const Table &table(void) const noexcept
+            {
+                static const Table empty;
+                if (this->data == nullptr)
+                    return empty;
+                return *this->data.alloc;
+            }
+        };
+
+        // Returns empty map with room for at least hint entries.
+        static jule::Map<Key, Value> alloc(const jule::Int &hint)
+        {
+            if (__JULE_UNLIKELY(hint < 0))
+                jule::panic_error("runtime: map: map allocation hint lower than zero");
+
+            jule::Map<Key, Value> map;
+            map.reserve(hint);
+            return map;
+        }
 
         Map(void) = default;
         Map(const std::nullptr_t) : Map() {}
 
+        Map(const jule::Map<Key, Value> &src) noexcept
+        {
+            this->__get_copy(src);
+        }
+
+        Map(jule::Map<Key, Value> &&src) noexcept : data(std::move(src.data))
+        {
+            src.data.alloc = nullptr;
+        }
+
         Map(const std::initializer_list<std::pair<Key, Value>> &src)
         {
+            if (src.size() == 0)
+                return;
+            Table &table = this->__mut();
+            table.reserve(src.size());
             for (const std::pair<Key, Value> &pair : src)
-                this->buffer.insert(pair);
+                table.insert(pair.first, pair.second);
         }
 
-        constexpr auto begin(void) noexcept
+        // Copy content from source.
+        void __get_copy(const jule::Map<Key, Value> &src) noexcept
         {
-            return this->buffer.begin();
+#ifdef __JULE_DISABLE__REFERENCE_COUNTING
+            // Sharing is not trackable without reference counts.
+            if (src.data != nullptr && src.data->size > 0)
+                this->data = jule::new_ptr<Table>(*src.data.alloc);
+            else
+                this->data = nullptr;
+#else
+            this->data = src.data;
+#endif
         }
 
-        constexpr auto begin(void) const noexcept
+        // Returns table for iterating. Nil maps iterate the empty table.
+        inline const Table &__table(void) const noexcept
         {
-            return this->buffer.begin();
+            static const Table empty;
+            if (this->data == nullptr)
+                return empty;
+            return *this->data.alloc;
         }
 
-        constexpr auto end(void) noexcept
+        // Returns table for writing.
+        // Allocates table of nil map, detaches table if shared.
+        Table &__mut(void) const
         {
-            return this->buffer.end();
+            if (this->data == nullptr)
+                this->data = jule::new_ptr<Table>(Table());
+#ifndef __JULE_DISABLE__REFERENCE_COUNTING
+            else if (this->data.get_ref_n() != jule::REFERENCE_DELTA * (1 + this->data.alloc->held()))
+                this->data = jule::new_ptr<Table>(*this->data.alloc);
+#endif
+            return *this->data.alloc;
         }
 
-        constexpr auto end(void) const noexcept
+        // Returns hold of table for ranging.
+        inline Hold __hold(void) const noexcept
         {
-            return this->buffer.end();
+            return Hold(this->data);
         }
 
-        constexpr void clear(void) noexcept
+        inline Iterator begin(void) const noexcept
         {
-            this->buffer.clear();
+            return this->__table().begin();
+        }
+
+        inline Iterator end(void) const noexcept
+        {
+            return this->__table().end();
+        }
+
+        void clear(void) noexcept
+        {
+            if (this->data == nullptr)
+                return;
+#ifndef __JULE_DISABLE__REFERENCE_COUNTING
+            // Shared, leave table to other copies.
+            if (this->data.get_ref_n() != jule::REFERENCE_DELTA)
+            {
+                this->data = nullptr;
+                return;
+            }
+#endif
+            this->data->clear();
+        }
+
+        // Reserves room for at least n entries.
+        // Following insertions do not rehash until map holds n entries.
+        void reserve(const jule::Int &n)
+        {
+            if (n <= this->len())
+                return;
+            this->__mut().reserve(static_cast<std::size_t>(n));
+        }
+
+        // Releases unused capacity of table.
+        void shrink(void)
+        {
+            if (this->data == nullptr)
+                return;
+            this->__mut().shrink();
         }
 
         jule::Slice<Key> keys(void) const noexcept
         {
-            jule::Slice<Key> keys = jule::Slice<Key>::alloc(this->len());
-            jule::Uint index = 0;
+            jule::Slice<Key> keys = jule::Slice<Key>::alloc(0, this->len());
             for (const auto &pair : *this)
-                keys._slice[index++] = pair.first;
+                keys.__push(pair.first);
             return keys;
         }
 
         jule::Slice<Value> values(void) const noexcept
         {
-            jule::Slice<Value> keys = jule::Slice<Value>::alloc(this->len());
-            jule::Uint index = 0;
+            jule::Slice<Value> keys = jule::Slice<Value>::alloc(0, this->len());
             for (const auto &pair : *this)
-                keys._slice[index++] = pair.second;
+                keys.__push(pair.second);
             return keys;
         }
 
-        constexpr jule::Bool has(const Key &key) const
+        inline jule::Bool has(const Key &key) const
+        {
+            return this->data != nullptr && this->data.alloc->find(key) != Table::NPOS;
+        }
+
+        // Returns pointer to value of key, nullptr if key is not exist.
+        // Never inserts, pointer is valid until next write to map.
+        inline Value *find(const Key &key) const
         {
-            return this->buffer.find(key) != this->end();
+            if (this->data == nullptr)
+                return nullptr;
+            const std::size_t index = this->data.alloc->find(key);
+            if (index == Table::NPOS)
+                return nullptr;
+            return &this->data.alloc->slots[index].second;
         }
 
-        constexpr jule::Int len(void) const noexcept
+        // Returns copy of value of key, default value if key is not exist.
+        // Never inserts, so reading missing keys does not grow the table.
+        inline Value lookup(const Key &key) const
         {
-            return this->buffer.size();
+            const Value *value = this->find(key);
+            if (value == nullptr)
+                return Value();
+            return *value;
         }
 
-        inline void del(const Key &key)
+        inline jule::Int len(void) const noexcept
         {
-            this->buffer.erase(key);
+            if (this->data == nullptr)
+                return 0;
+            return static_cast<jule::Int>(this->data.alloc->size);
         }
 
-        constexpr jule::Bool operator==(const std::nullptr_t) const noexcept
+        void del(const Key &key)
         {
-            return this->buffer.empty();
+            // Lookup first, deleting missing key should not detach table.
+            if (!this->has(key))
+                return;
+            Table &table = this->__mut();
+            table.erase(table.find(key));
         }
 
-        constexpr jule::Bool operator!=(const std::nullptr_t) const noexcept
+        inline jule::Bool operator==(const std::nullptr_t) const noexcept
+        {
+            return this->len() == 0;
+        }
+
+        inline jule::Bool operator!=(const std::nullptr_t) const noexcept
         {
             return !this->operator==(nullptr);
         }
 
-        Value &operator[](const Key &key) noexcept
+        // Sets value of key, inserts key if not exist.
+        // Assignments to elements use it instead of operator[], value is
+        // evaluated before table is written, so value may write to map.
+        void set(const Key &key, Value value)
+        {
+            this->__mut().insert(key, std::move(value));
+        }
+
+        Value &operator[](const Key &key)
+        {
+            Table &table = this->__mut();
+            // Insertion may reallocate slots, take index first.
+            const std::size_t index = table.find_or_insert(key);
+            return table.slots[index].second;
+        }
+
+        Value &operator[](const Key &key) const
+        {
+            Table &table = this->__mut();
+            // Insertion may reallocate slots, take index first.
+            const std::size_t index = table.find_or_insert(key);
+            return table.slots[index].second;
+        }
+
+        jule::Map<Key, Value> &operator=(const jule::Map<Key, Value> &src) noexcept
         {
-            return this->buffer[key];
+            // Assignment to itself.
+            if (this == &src)
+                return *this;
+            this->__get_copy(src);
+            return *this;
         }
 
-        Value &operator[](const Key &key) const noexcept
+        jule::Map<Key, Value> &operator=(jule::Map<Key, Value> &&src) noexcept
         {
-            return this->buffer[key];
+            this->data = std::move(src.data);
+            return *this;
         }
 
         friend std::ostream &operator<<(std::ostream &stream,
@@ -138,7 +897,7 @@ namespace jule
         {
             stream << '{';
             jule::Int length = src.len();
-            for (const auto pair : src)
+            for (const auto &pair : src)
             {
                 stream << pair.first;
                 stream << ':';
@@ -5,7 +5,9 @@
 #ifndef __JULE_MISC_HPP
 #define __JULE_MISC_HPP
 
+#include <new>
 #include <string>
+#include <utility>
 
 #include "error.hpp"
 #include "panic.hpp"
@@ -28,16 +30,12 @@ namespace jule
             const T &x, const Denominator &denominator) noexcept
         {
 #ifndef __JULE_DISABLE__SAFETY
-                if (denominator == 0)
-                {
+                if (__JULE_UNLIKELY(denominator == 0))
+                        jule::panic_error(__JULE_ERROR__DIVIDE_BY_ZERO "\nruntime: divide-by-zero occurred when division"
 #ifndef __JULE_ENABLE__PRODUCTION
-                        std::string error = __JULE_ERROR__DIVIDE_BY_ZERO "\nruntime: divide-by-zero occurred when division\nfile: ";
-                        error += file;
-                        jule::panic(error);
-#else
-                        jule::panic(__JULE_ERROR__DIVIDE_BY_ZERO "\nruntime: divide-by-zero occurred when division");
-#endif // PRODUCTION
-                }
+                                          , file
+#endif
+                        );
 #endif // SAFETY
                 return x / denominator;
         }
@@ -50,16 +48,12 @@ namespace jule
             const T &x, const Denominator &denominator) noexcept
         {
 #ifndef __JULE_DISABLE__SAFETY
-                if (denominator == 0)
-                {
+                if (__JULE_UNLIKELY(denominator == 0))
+                        jule::panic_error(__JULE_ERROR__DIVIDE_BY_ZERO "\nruntime: divide-by-zero occurred when modulo"
 #ifndef __JULE_ENABLE__PRODUCTION
-                        std::string error = __JULE_ERROR__DIVIDE_BY_ZERO "\nruntime: divide-by-zero occurred when modulo\nfile: ";
-                        error += file;
-                        jule::panic(error);
-#else
-                        jule::panic(__JULE_ERROR__DIVIDE_BY_ZERO "\nruntime: divide-by-zero occurred when modulo");
-#endif // PRODUCTION
-                }
+                                          , file
+#endif
+                        );
 #endif // SAFETY
                 return x % denominator;
         }
@@ -84,59 +78,59 @@ namespace jule
                 return x % denominator;
         }
 
-        template <typename T>
-        jule::Ptr<T> new_struct(
+        template <typename T, typename... Args>
+        jule::PtrBlock<T> *new_struct_block(
 #ifndef __JULE_ENABLE__PRODUCTION
             const char *file,
 #endif
-            T *ptr) noexcept
+            Args &&...args) noexcept
         {
-                if (!ptr)
-                {
+                jule::PtrBlock<T> *block = new (std::nothrow) jule::PtrBlock<T>(std::forward<Args>(args)...);
+                if (__JULE_UNLIKELY(!block))
+                        jule::panic_error(__JULE_ERROR__MEMORY_ALLOCATION_FAILED "\nruntime: allocation failed for structure"
 #ifndef __JULE_ENABLE__PRODUCTION
-                        std::string error = __JULE_ERROR__MEMORY_ALLOCATION_FAILED "\nruntime: allocation failed for structure\nfile: ";
-                        error += file;
-                        jule::panic(error);
-#else
-                        jule::panic(__JULE_ERROR__MEMORY_ALLOCATION_FAILED "\nruntime: allocation failed for structure");
+                                          , file
 #endif
-                }
+                        );
+                return block;
+        }
 
-#ifndef __JULE_DISABLE__REFERENCE_COUNTING
-                return jule::Ptr<T>::make(ptr);
+        // Allocates structure constructed by arguments.
+        // Structure and its reference counter are single allocation.
+        template <typename T, typename... Args>
+        jule::Ptr<T> new_struct(
+#ifndef __JULE_ENABLE__PRODUCTION
+            const char *file,
 #endif
-
-                return jule::Ptr<T>::make(ptr, nullptr);
+            Args &&...args) noexcept
+        {
+                jule::PtrBlock<T> *block = jule::new_struct_block<T>(
+#ifndef __JULE_ENABLE__PRODUCTION
+                    file,
+#endif
+                    std::forward<Args>(args)...);
+                return jule::Ptr<T>::make(&block->value, &block->n);
         }
 
-        template <typename T>
+        // Same as new_struct, but for structures which have self reference.
+        // Structure is constructed in place, so its self field points to it.
+        template <typename T, typename... Args>
         jule::Ptr<T> new_struct_ptr(
 #ifndef __JULE_ENABLE__PRODUCTION
             const char *file,
 #endif
-            T *ptr) noexcept
+            Args &&...args) noexcept
         {
-                if (!ptr)
-                {
+                jule::PtrBlock<T> *block = jule::new_struct_block<T>(
 #ifndef __JULE_ENABLE__PRODUCTION
-                        std::string error = __JULE_ERROR__MEMORY_ALLOCATION_FAILED "\nruntime: allocation failed for structure\nfile: ";
-                        error += file;
-                        jule::panic(error);
-#else
-                        jule::panic(__JULE_ERROR__MEMORY_ALLOCATION_FAILED "\nruntime: allocation failed for structure");
-#endif
-                }
-
-#ifndef __JULE_DISABLE__REFERENCE_COUNTING
-                ptr->self.ref = new (std::nothrow) jule::Uint;
-                if (!ptr->self.ref)
-                        jule::panic(__JULE_ERROR__MEMORY_ALLOCATION_FAILED "\nruntime: allocation failed for structure");
-
-                // Initialize with zero because return reference is counts 1 reference.
-                *ptr->self.ref = 0; // ( jule::REFERENCE_DELTA - jule::REFERENCE_DELTA );
+                    file,
 #endif
+                    std::forward<Args>(args)...);
 
-                return ptr->self;
+                // Self reference is not counted, returned reference
+                // takes the initial count of block.
+                block->value.self.ref = &block->n;
+                return jule::Ptr<T>::make(&block->value, &block->n);
         }
 } // namespace jule
 
@@ -6,8 +6,13 @@
 #define __JULE_PANIC_HPP
 
 #include <iostream>
+#include <string>
 #include <vector>
 
+#include "platform.hpp"
+#include "types.hpp"
+#include "error.hpp"
+
 #ifdef OS_WINDOWS
 #include "windows.h"
 
@@ -21,7 +26,7 @@ namespace jule
 {
     constexpr signed int EXIT_PANIC = 2;
 
-    inline void panic(const std::string &expr) noexcept
+    [[noreturn]] __JULE_COLD inline void panic(const std::string &expr) noexcept
     {
         std::cerr << "panic: ";
 #ifdef OS_WINDOWS
@@ -34,6 +39,56 @@ namespace jule
         std::exit(jule::EXIT_PANIC);
     }
 
+    // Cold paths of safety checks.
+    // Error messages are built out of line, so inlined checks keep only
+    // the comparison and call at call sites.
+    // File is location of failed check, nullptr if not available.
+
+    [[noreturn]] __JULE_COLD inline void panic_error(const char *error,
+                                                     const char *file = nullptr) noexcept
+    {
+        std::string expr = error;
+        if (file)
+        {
+            expr += "\nfile: ";
+            expr += file;
+        }
+        jule::panic(expr);
+    }
+
+    [[noreturn]] __JULE_COLD inline void panic_index(const char *error,
+                                                     const jule::Int index,
+                                                     const jule::Int len,
+                                                     const char *file = nullptr) noexcept
+    {
+        std::string expr;
+        __JULE_WRITE_ERROR_INDEX_OUT_OF_RANGE(expr, index, len);
+        expr += error;
+        if (file)
+        {
+            expr += "\nfile: ";
+            expr += file;
+        }
+        jule::panic(expr);
+    }
+
+    [[noreturn]] __JULE_COLD inline void panic_slicing(const char *error,
+                                                       const jule::Int start,
+                                                       const jule::Int end,
+                                                       const jule::Int len,
+                                                       const char *file = nullptr) noexcept
+    {
+        std::string expr;
+        __JULE_WRITE_ERROR_SLICING_INDEX_OUT_OF_RANGE(expr, start, end, len);
+        expr += error;
+        if (file)
+        {
+            expr += "\nfile: ";
+            expr += file;
+        }
+        jule::panic(expr);
+    }
+
 } // namespace jule
 
 #endif // ifndef __JULE_PANIC_HPP
@@ -17,6 +17,15 @@
 #define OS_UNIX
 #endif
 
+// Concurrent calls run on green threads which use ucontext of glibc.
+// Other platforms run concurrent calls on stacks of worker threads.
+#ifdef OS_LINUX
+#include <features.h>
+#endif
+#if defined(OS_LINUX) && defined(__GLIBC__) && !defined(__JULE_DISABLE__GREEN_THREADS)
+#define __JULE_GREEN_THREADS
+#endif
+
 #if defined(__amd64) || defined(__amd64__) || defined(__x86_64) || defined(__x86_64__) || defined(_M_AMD64)
 #define ARCH_AMD64
 #elif defined(__arm__) || defined(__thumb__) || defined(_M_ARM) || defined(__arm)
@@ -33,4 +42,14 @@
 #define ARCH_X32
 #endif
 
+#if defined(__GNUC__) || defined(__clang__)
+#define __JULE_LIKELY(EXPR) __builtin_expect(!!(EXPR), 1)
+#define __JULE_UNLIKELY(EXPR) __builtin_expect(!!(EXPR), 0)
+#define __JULE_COLD [[gnu::cold, gnu::noinline]]
+#else
+#define __JULE_LIKELY(EXPR) (EXPR)
+#define __JULE_UNLIKELY(EXPR) (EXPR)
+#define __JULE_COLD
+#endif
+
 #endif // ifndef __JULE_PLATFORM_HPP
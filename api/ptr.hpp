@@ -5,9 +5,15 @@
 #ifndef __JULE_PTR_HPP
 #define __JULE_PTR_HPP
 
+#include <new>
 #include <string>
 #include <ostream>
+#include <utility>
+#ifdef __JULE_ENABLE__BIASED_REFERENCE_COUNTING
+#include <mutex>
+#endif
 
+#include "platform.hpp"
 #include "atomic.hpp"
 #include "types.hpp"
 #include "error.hpp"
@@ -20,12 +26,70 @@ namespace jule
     // per each reference counting operation.
     constexpr signed int REFERENCE_DELTA = 1;
 
+    // Control block of reference-counted allocations.
+    // Reference counter is the first member, so the reference counter
+    // pointer of jule::Ptr also addresses the control block of allocation.
+    struct RefBlock;
+
+#ifdef __JULE_ENABLE__BIASED_REFERENCE_COUNTING
+    // Shift of count in the shared counter of biased reference counting.
+    // Low bits of shared counter are state bits.
+    constexpr signed int RC_SHARED_SHIFT = 2;
+
+    // Shared counter state: biased counter merged into shared counter.
+    // Block is counted by shared counter only.
+    constexpr jule::Int RC_MERGED = 1;
+
+    // Shared counter state: block queued to be merged by owner thread.
+    constexpr jule::Int RC_QUEUED = 2;
+
+    // Owner thread of biased reference counting.
+    // Blocks of thread are counted by biased counter non-atomically,
+    // other threads use atomic shared counter. When shared counter
+    // becomes negative, the thread which drops reference queues block
+    // to owner and owner merges biased counter into shared counter.
+    struct RcThread;
+
+    // Returns owner thread for new block.
+    // Returns nullptr if current thread is exiting, so block is born merged.
+    inline jule::RcThread *rc_thread_owner(void) noexcept;
+
+    // Returns current thread if registered.
+    // Green threads are owners by themselves, because they may migrate
+    // between threads. Scheduler switches current thread with green threads.
+    inline jule::RcThread *&rc_thread_current(void) noexcept;
+
+    // Releases thread to be reused by new owners.
+    // Owner drains thread and stops using it before release.
+    inline void rc_thread_release(jule::RcThread *thread) noexcept;
+#endif // __JULE_ENABLE__BIASED_REFERENCE_COUNTING
+
+    // Merges blocks queued to current thread, if any.
+    // Called at safe points where owner may stay idle, so blocks released
+    // by other threads are not held until owner allocates again.
+    // Callers must not hold locks of runtime, merged blocks may be freed.
+    // Has no effect without biased reference counting.
+    inline void rc_thread_drain(void) noexcept;
+
+    // Control block that co-allocated with the managed object.
+    // Reference counter and object are single heap allocation.
+    template <typename T>
+    struct PtrBlock;
+
+    // Control block of allocation that adopted from raw pointer.
+    template <typename T>
+    struct ExternBlock;
+
     // Wrapper structure for raw pointer of JuleC.
     // This structure is the used by Jule references for reference-counting
     // and memory management.
     template <typename T>
     struct Ptr;
 
+    // Allocates control block with object constructed by arguments.
+    template <typename T, typename... Args>
+    inline jule::PtrBlock<T> *new_ptr_block(Args &&...args) noexcept;
+
     // Equavelent of Jule's new(T) call.
     template <typename T>
     inline jule::Ptr<T> new_ptr(void) noexcept;
@@ -34,16 +98,444 @@ namespace jule
     template <typename T>
     inline jule::Ptr<T> new_ptr(const T &init) noexcept;
 
+    struct RefBlock
+    {
+        // Reference counter.
+        // Biased counter of owner thread if biased reference counting enabled.
+        jule::Uint n = jule::REFERENCE_DELTA;
+
+        // Destroys managed allocation and frees control block itself.
+        void (*destroy)(jule::RefBlock *block) noexcept = nullptr;
+
+#ifdef __JULE_ENABLE__BIASED_REFERENCE_COUNTING
+        // Owner thread, nullptr if merged. Accessed atomically.
+        jule::RcThread *owner = nullptr;
+
+        // Shared counter of non-owner threads. Accessed atomically.
+        // Count is shifted by jule::RC_SHARED_SHIFT and may be negative
+        // until merge, low bits are jule::RC_MERGED and jule::RC_QUEUED.
+        jule::Int shared = 0;
+
+        // Next block in the merge queue of owner thread.
+        jule::RefBlock *queued = nullptr;
+
+        RefBlock(void) noexcept
+        {
+            this->owner = jule::rc_thread_owner();
+            if (!this->owner)
+            {
+                this->n = 0;
+                this->shared = (static_cast<jule::Int>(jule::REFERENCE_DELTA) << jule::RC_SHARED_SHIFT) | jule::RC_MERGED;
+            }
+        }
+
+        // Reports whether current thread is owner of block.
+        inline jule::Bool owned(void) noexcept
+        {
+            jule::RcThread *owner = __jule_atomic_load_explicit(
+                &this->owner, __JULE_ATOMIC_MEMORY_ORDER__RELAXED);
+            return owner && owner == jule::rc_thread_current();
+        }
+
+        // Sets biased counter. Only owner thread writes biased counter,
+        // atomic store is used to make racy reads of other threads safe.
+        inline void set_biased(jule::Uint n) noexcept
+        {
+            __jule_atomic_store_explicit(&this->n, n, __JULE_ATOMIC_MEMORY_ORDER__RELAXED);
+        }
+
+        inline void add_ref(void) noexcept
+        {
+            if (this->owned())
+                this->set_biased(this->n + jule::REFERENCE_DELTA);
+            else
+                __jule_atomic_add_explicit(
+                    &this->shared,
+                    static_cast<jule::Int>(jule::REFERENCE_DELTA) << jule::RC_SHARED_SHIFT,
+                    __JULE_ATOMIC_MEMORY_ORDER__RELAXED);
+        }
+
+        // Drops reference.
+        // Reports whether last reference dropped and block must be freed.
+        inline jule::Bool drop_ref(void) noexcept
+        {
+            if (!this->owned())
+                return this->drop_shared();
+            this->set_biased(this->n - jule::REFERENCE_DELTA);
+            if (this->n)
+                return false;
+            return this->merge_unqueued();
+        }
+
+        inline jule::Uint get_ref_n(void) noexcept
+        {
+            const jule::Uint n = __jule_atomic_load_explicit(
+                &this->n, __JULE_ATOMIC_MEMORY_ORDER__RELAXED);
+            const jule::Int shared = __jule_atomic_load_explicit(
+                &this->shared, __JULE_ATOMIC_MEMORY_ORDER__RELAXED);
+            return n + static_cast<jule::Uint>(shared >> jule::RC_SHARED_SHIFT);
+        }
+
+        // Drops reference of non-owner thread.
+        // Queues block to owner if shared counter becomes negative first time.
+        jule::Bool drop_shared(void) noexcept;
+
+        // Merges block by owner thread when biased counter reaches zero.
+        // Merging is left to queue processing if block is queued.
+        jule::Bool merge_unqueued(void) noexcept
+        {
+            jule::Int old = __jule_atomic_load_explicit(
+                &this->shared, __JULE_ATOMIC_MEMORY_ORDER__RELAXED);
+            jule::Int merged;
+            do
+            {
+                if (old & jule::RC_QUEUED)
+                    return false;
+                merged = old | jule::RC_MERGED;
+            } while (!__jule_atomic_compare_swap_explicit(
+                &this->shared, &old, merged,
+                __JULE_ATOMIC_MEMORY_ORDER__ACQ_REL,
+                __JULE_ATOMIC_MEMORY_ORDER__RELAXED));
+            jule::RcThread *owner = nullptr;
+            __jule_atomic_store_explicit(&this->owner, owner, __JULE_ATOMIC_MEMORY_ORDER__RELAXED);
+            return (merged >> jule::RC_SHARED_SHIFT) == 0;
+        }
+
+        // Merges queued block by owner thread.
+        // Reports whether block must be freed.
+        jule::Bool merge_queued(void) noexcept
+        {
+            const jule::Int biased = static_cast<jule::Int>(this->n) << jule::RC_SHARED_SHIFT;
+            this->set_biased(0);
+            jule::RcThread *owner = nullptr;
+            __jule_atomic_store_explicit(&this->owner, owner, __JULE_ATOMIC_MEMORY_ORDER__RELAXED);
+            const jule::Int old = __jule_atomic_add_explicit(
+                &this->shared, biased | jule::RC_MERGED,
+                __JULE_ATOMIC_MEMORY_ORDER__ACQ_REL);
+            return ((old + biased) >> jule::RC_SHARED_SHIFT) == 0;
+        }
+#endif // __JULE_ENABLE__BIASED_REFERENCE_COUNTING
+
+        // Returns control block of reference counter.
+        static inline jule::RefBlock *of(jule::Uint *ref) noexcept
+        {
+            return reinterpret_cast<jule::RefBlock *>(ref);
+        }
+    };
+
+#ifdef __JULE_ENABLE__BIASED_REFERENCE_COUNTING
+    struct RcThread
+    {
+        // Merge queue. Non-owner threads push blocks atomically.
+        jule::RefBlock *queue = nullptr;
+
+        // Next thread in the list of free threads.
+        jule::RcThread *next = nullptr;
+
+        // Pushes block to merge queue.
+        void push(jule::RefBlock *block) noexcept
+        {
+            jule::RefBlock *head = __jule_atomic_load_explicit(
+                &this->queue, __JULE_ATOMIC_MEMORY_ORDER__RELAXED);
+            do
+                block->queued = head;
+            while (!__jule_atomic_compare_swap_explicit(
+                &this->queue, &head, block,
+                __JULE_ATOMIC_MEMORY_ORDER__RELEASE,
+                __JULE_ATOMIC_MEMORY_ORDER__RELAXED));
+        }
+
+        // Merges queued blocks. Called by owner thread.
+        // Merged blocks which have no reference are freed.
+        void drain(void) noexcept
+        {
+            for (;;)
+            {
+                jule::RefBlock *block = nullptr;
+                block = __jule_atomic_swap_explicit(
+                    &this->queue, block, __JULE_ATOMIC_MEMORY_ORDER__ACQUIRE);
+                if (!block)
+                    return;
+                while (block)
+                {
+                    jule::RefBlock *next = block->queued;
+                    if (block->merge_queued())
+                        block->destroy(block);
+                    block = next;
+                }
+            }
+        }
+    };
+
+    // Marks current thread as exited.
+    // Blocks allocated by exited thread are born merged.
+    static jule::RcThread *const RC_THREAD_EXITED = reinterpret_cast<jule::RcThread *>(1);
+
+    // Mutex of free threads.
+    inline std::mutex &rc_thread_mutex(void) noexcept
+    {
+        static std::mutex mutex;
+        return mutex;
+    }
+
+    // Threads of exited threads, reused by new threads.
+    // Blocks queued to thread after exit are merged by next owner.
+    inline jule::RcThread *&rc_thread_free(void) noexcept
+    {
+        static jule::RcThread *free = nullptr;
+        return free;
+    }
+
+    struct RcThreadLocal
+    {
+        // Not inlined with green threads, address of thread-local variable
+        // must not be cached across migration.
+#ifdef __JULE_GREEN_THREADS
+        __attribute__((noinline))
+#endif
+        static jule::RcThread *&current(void) noexcept
+        {
+            static thread_local jule::RcThread *current = nullptr;
+            return current;
+        }
+    };
+
+    inline jule::RcThread *&rc_thread_current(void) noexcept
+    {
+        return jule::RcThreadLocal::current();
+    }
+
+    inline void rc_thread_release(jule::RcThread *thread) noexcept
+    {
+        std::lock_guard<std::mutex> lock(jule::rc_thread_mutex());
+        thread->next = jule::rc_thread_free();
+        jule::rc_thread_free() = thread;
+    }
+
+    // Releases thread at exit of thread.
+    struct RcThreadExit
+    {
+        ~RcThreadExit(void) noexcept
+        {
+            jule::RcThread *thread = jule::rc_thread_current();
+            // Thread may be registered by green threads only,
+            // they release their own threads.
+            if (!thread || thread == jule::RC_THREAD_EXITED)
+                return;
+            thread->drain();
+            jule::rc_thread_current() = jule::RC_THREAD_EXITED;
+            jule::rc_thread_release(thread);
+        }
+    };
+
+    // Registers current thread.
+    inline jule::RcThread *rc_thread_register(void) noexcept
+    {
+        static thread_local jule::RcThreadExit exit;
+        (void)exit;
+
+        jule::RcThread *thread;
+        {
+            std::lock_guard<std::mutex> lock(jule::rc_thread_mutex());
+            thread = jule::rc_thread_free();
+            if (thread)
+                jule::rc_thread_free() = thread->next;
+        }
+        if (!thread)
+        {
+            thread = new (std::nothrow) jule::RcThread;
+            if (__JULE_UNLIKELY(!thread))
+                jule::panic_error(__JULE_ERROR__MEMORY_ALLOCATION_FAILED
+                                  "\nruntime: memory allocation failed for reference counting thread");
+        }
+        thread->next = nullptr;
+        jule::rc_thread_current() = thread;
+        // Merge blocks which are queued after exit of previous owner.
+        thread->drain();
+        return thread;
+    }
+
+    inline jule::RcThread *rc_thread_owner(void) noexcept
+    {
+        jule::RcThread *thread = jule::rc_thread_current();
+        if (!thread)
+            return jule::rc_thread_register();
+        if (thread == jule::RC_THREAD_EXITED)
+            return nullptr;
+        // Allocation is the safe point of thread to merge queued blocks.
+        if (__jule_atomic_load_explicit(&thread->queue, __JULE_ATOMIC_MEMORY_ORDER__RELAXED))
+            thread->drain();
+        return thread;
+    }
+
+    inline jule::Bool RefBlock::drop_shared(void) noexcept
+    {
+        constexpr jule::Int delta = static_cast<jule::Int>(jule::REFERENCE_DELTA) << jule::RC_SHARED_SHIFT;
+        jule::Int old = __jule_atomic_load_explicit(
+            &this->shared, __JULE_ATOMIC_MEMORY_ORDER__RELAXED);
+        jule::Int n;
+        jule::Bool queue;
+        do
+        {
+            n = old - delta;
+            // Biased counter holds the dropped reference.
+            queue = !(old & (jule::RC_MERGED | jule::RC_QUEUED)) && n < 0;
+            if (queue)
+                n |= jule::RC_QUEUED;
+        } while (!__jule_atomic_compare_swap_explicit(
+            &this->shared, &old, n,
+            __JULE_ATOMIC_MEMORY_ORDER__ACQ_REL,
+            __JULE_ATOMIC_MEMORY_ORDER__RELAXED));
+        if (queue)
+        {
+            // Owner cannot merge queued block until queue processing,
+            // so owner is stable.
+            jule::RcThread *owner = __jule_atomic_load_explicit(
+                &this->owner, __JULE_ATOMIC_MEMORY_ORDER__RELAXED);
+            owner->push(this);
+            return false;
+        }
+        return (n & jule::RC_MERGED) && (n >> jule::RC_SHARED_SHIFT) == 0;
+    }
+#endif // __JULE_ENABLE__BIASED_REFERENCE_COUNTING
+
+    inline void rc_thread_drain(void) noexcept
+    {
+#ifdef __JULE_ENABLE__BIASED_REFERENCE_COUNTING
+        jule::RcThread *thread = jule::rc_thread_current();
+        if (!thread || thread == jule::RC_THREAD_EXITED)
+            return;
+        if (__jule_atomic_load_explicit(&thread->queue, __JULE_ATOMIC_MEMORY_ORDER__RELAXED))
+            thread->drain();
+#endif
+    }
+
+    // Counting functions of reference counters in control blocks.
+    // drop_ref and add_ref return count before the operation.
+#ifdef __JULE_DISABLE__ATOMIC_REFERENCE_COUNTING
+    // Single-threaded program, reference counters are never shared
+    // between threads. Plain increments and decrements are enough.
+
+    inline jule::Int drop_ref(jule::Uint *ref) noexcept
+    {
+        const jule::Uint n = *ref;
+        *ref = n - jule::REFERENCE_DELTA;
+        return n;
+    }
+
+    inline jule::Int add_ref(jule::Uint *ref) noexcept
+    {
+        const jule::Uint n = *ref;
+        *ref = n + jule::REFERENCE_DELTA;
+        return n;
+    }
+
+    inline jule::Uint get_ref_n(jule::Uint *ref) noexcept
+    {
+        return *ref;
+    }
+#elif defined(__JULE_ENABLE__BIASED_REFERENCE_COUNTING)
+    // Biased reference counting, see jule::RcThread.
+    // Returns jule::REFERENCE_DELTA if last reference dropped,
+    // like previous count of non-biased counting.
+
+    inline jule::Int drop_ref(jule::Uint *ref) noexcept
+    {
+        return jule::RefBlock::of(ref)->drop_ref() ? jule::REFERENCE_DELTA : 0;
+    }
+
+    inline jule::Int add_ref(jule::Uint *ref) noexcept
+    {
+        jule::RefBlock::of(ref)->add_ref();
+        return 0;
+    }
+
+    inline jule::Uint get_ref_n(jule::Uint *ref) noexcept
+    {
+        return jule::RefBlock::of(ref)->get_ref_n();
+    }
+#else
+    inline jule::Int drop_ref(jule::Uint *ref) noexcept
+    {
+        return __jule_atomic_add_explicit(
+            ref,
+            -jule::REFERENCE_DELTA,
+            __JULE_ATOMIC_MEMORY_ORDER__RELAXED);
+    }
+
+    inline jule::Int add_ref(jule::Uint *ref) noexcept
+    {
+        return __jule_atomic_add_explicit(
+            ref,
+            jule::REFERENCE_DELTA,
+            __JULE_ATOMIC_MEMORY_ORDER__RELAXED);
+    }
+
+    inline jule::Uint get_ref_n(jule::Uint *ref) noexcept
+    {
+        return __jule_atomic_load_explicit(
+            ref, __JULE_ATOMIC_MEMORY_ORDER__RELAXED);
+    }
+#endif // __JULE_DISABLE__ATOMIC_REFERENCE_COUNTING
+
+    template <typename T>
+    struct PtrBlock : public jule::RefBlock
+    {
+        T value;
+
+        template <typename... Args>
+        explicit PtrBlock(Args &&...args) : value(std::forward<Args>(args)...)
+        {
+            this->destroy = jule::PtrBlock<T>::destroy_block;
+        }
+
+        static void destroy_block(jule::RefBlock *block) noexcept
+        {
+            delete static_cast<jule::PtrBlock<T> *>(block);
+        }
+    };
+
+    template <typename T>
+    struct ExternBlock : public jule::RefBlock
+    {
+        T *ptr;
+
+        explicit ExternBlock(T *ptr) noexcept : ptr(ptr)
+        {
+            this->destroy = jule::ExternBlock<T>::destroy_block;
+        }
+
+        static void destroy_block(jule::RefBlock *block) noexcept
+        {
+            jule::ExternBlock<T> *extern_block = static_cast<jule::ExternBlock<T> *>(block);
+            delete extern_block->ptr;
+            delete extern_block;
+        }
+    };
+
+    template <typename T, typename... Args>
+    inline jule::PtrBlock<T> *new_ptr_block(Args &&...args) noexcept
+    {
+        jule::PtrBlock<T> *block = new (std::nothrow) jule::PtrBlock<T>(std::forward<Args>(args)...);
+        if (__JULE_UNLIKELY(!block))
+            jule::panic_error(__JULE_ERROR__MEMORY_ALLOCATION_FAILED
+                              "\nruntime: memory allocation failed for heap of reference type");
+        return block;
+    }
+
     template <typename T>
     struct Ptr
     {
         mutable T *alloc = nullptr;
+
+        // Reference counter in the control block of allocation.
+        // Reference does not counted if it is null.
         mutable jule::Uint *ref = nullptr;
 
         // Creates new reference from allocation and reference counting
         // allocation. Reference does not counted if reference count
         // allocation is null.
-        static jule::Ptr<T> make(T *ptr, const jule::Uint *ref) noexcept
+        static jule::Ptr<T> make(T *ptr, jule::Uint *ref) noexcept
         {
             jule::Ptr<T> buffer;
             buffer.alloc = ptr;
@@ -52,52 +544,31 @@ namespace jule
         }
 
         // Creates new reference from allocation.
-        // Allocates new allocation for reference counting data and
+        // Adopts allocation, allocates control block for it and
         // starts counting to jule::REFERENCE_DELTA.
         static jule::Ptr<T> make(T *ptr) noexcept
         {
-            jule::Ptr<T> buffer;
-
-#ifndef __JULE_DISABLE__REFERENCE_COUNTING
-            buffer.ref = new (std::nothrow) jule::Uint;
-            if (!buffer.ref)
-                jule::panic(__JULE_ERROR__MEMORY_ALLOCATION_FAILED
-                            "\nruntime: memory allocation failed for reference counter of reference type");
-
-            *buffer.ref = jule::REFERENCE_DELTA;
-#endif
-
-            buffer.alloc = ptr;
-            return buffer;
+            jule::ExternBlock<T> *block = new (std::nothrow) jule::ExternBlock<T>(ptr);
+            if (__JULE_UNLIKELY(!block))
+                jule::panic_error(__JULE_ERROR__MEMORY_ALLOCATION_FAILED
+                                  "\nruntime: memory allocation failed for reference counter of reference type");
+            return jule::Ptr<T>::make(ptr, &block->n);
         }
 
-        static jule::Ptr<T> make(const T &instance, const jule::Uint *ref) noexcept
+        // Creates new reference to copy of instance.
+        // Object and its reference counter are single allocation.
+        static jule::Ptr<T> make(const T &instance) noexcept
         {
-            jule::Ptr<T> buffer;
-
-            buffer.alloc = new (std::nothrow) T;
-            if (!buffer.alloc)
-                jule::panic(__JULE_ERROR__MEMORY_ALLOCATION_FAILED
-                            "\nruntime: memory allocation failed for heap of reference type");
-
-            *buffer.alloc = instance;
-            buffer.ref = ref;
-            return buffer;
+            return jule::Ptr<T>::emplace(instance);
         }
 
-        static jule::Ptr<T> make(const T &instance) noexcept
+        // Creates new reference to object constructed by arguments.
+        // Object and its reference counter are single allocation.
+        template <typename... Args>
+        static jule::Ptr<T> emplace(Args &&...args) noexcept
         {
-#ifdef __JULE_DISABLE__REFERENCE_COUNTING
-            return jule::Ptr<T>::make(instance, nullptr);
-#else
-            auto *ref = new (std::nothrow) jule::Uint;
-            if (!ref)
-                jule::panic(__JULE_ERROR__MEMORY_ALLOCATION_FAILED
-                            "\nruntime: memory allocation failed for reference counter of reference type");
-            *ref = jule::REFERENCE_DELTA;
-
-            return jule::Ptr<T>::make(instance, ref);
-#endif
+            jule::PtrBlock<T> *block = jule::new_ptr_block<T>(std::forward<Args>(args)...);
+            return jule::Ptr<T>::make(&block->value, &block->n);
         }
 
         Ptr(void) = default;
@@ -111,6 +582,7 @@ namespace jule
         Ptr(jule::Ptr<T> &&src) noexcept : alloc(src.alloc), ref(src.ref)
         {
             // Avoid deallocation.
+            src.alloc = nullptr;
             src.ref = nullptr;
         }
 
@@ -127,8 +599,10 @@ namespace jule
         // Copy content from source.
         void __get_copy(const jule::Ptr<T> &src) noexcept
         {
+#ifndef __JULE_DISABLE__REFERENCE_COUNTING
             if (src.ref)
                 src.add_ref();
+#endif
 
             this->ref = src.ref;
             this->alloc = src.alloc;
@@ -136,34 +610,29 @@ namespace jule
 
         inline jule::Int drop_ref(void) const noexcept
         {
-            return __jule_atomic_add_explicit(
-                this->ref,
-                -jule::REFERENCE_DELTA,
-                __JULE_ATOMIC_MEMORY_ORDER__RELAXED);
+            return jule::drop_ref(this->ref);
         }
 
         inline jule::Int add_ref(void) const noexcept
         {
-            return __jule_atomic_add_explicit(
-                this->ref,
-                jule::REFERENCE_DELTA,
-                __JULE_ATOMIC_MEMORY_ORDER__RELAXED);
+            return jule::add_ref(this->ref);
         }
 
         inline jule::Uint get_ref_n(void) const noexcept
         {
-            return __jule_atomic_load_explicit(
-                this->ref, __JULE_ATOMIC_MEMORY_ORDER__RELAXED);
+            return jule::get_ref_n(this->ref);
         }
 
         // Frees memory. Unsafe function, not includes any safety checking for
         // heap allocations are valid or something like that.
         void __free(void) const noexcept
         {
-            delete this->ref;
-            this->ref = nullptr;
+            if (this->ref)
+                jule::RefBlock::of(this->ref)->destroy(jule::RefBlock::of(this->ref));
+            else
+                delete this->alloc;
 
-            delete this->alloc;
+            this->ref = nullptr;
             this->alloc = nullptr;
         }
 
@@ -172,6 +641,11 @@ namespace jule
         // Frees memory if reference counting reaches to zero.
         void dealloc(void) const noexcept
         {
+#ifdef __JULE_DISABLE__REFERENCE_COUNTING
+            // Not counted, allocation is released by explicit free only.
+            this->ref = nullptr;
+            this->alloc = nullptr;
+#else
             if (!this->ref)
             {
                 this->alloc = nullptr;
@@ -186,6 +660,7 @@ namespace jule
             }
 
             this->__free();
+#endif
         }
 
         inline T *ptr(
@@ -224,6 +699,13 @@ namespace jule
             return *this->alloc;
         }
 
+        // Returns reference to data.
+        // Not includes safety checking.
+        inline T &__get(void) const noexcept
+        {
+            return *this->alloc;
+        }
+
         inline T *operator->(void) const noexcept
         {
             return this->ptr(
@@ -260,16 +742,12 @@ namespace jule
 #endif
         ) const noexcept
         {
-            if (this->operator==(nullptr))
-            {
+            if (__JULE_UNLIKELY(this->operator==(nullptr)))
+                jule::panic_error(__JULE_ERROR__INVALID_MEMORY "\nruntime: reference type is nil"
 #ifndef __JULE_ENABLE__PRODUCTION
-                std::string error = __JULE_ERROR__INVALID_MEMORY "\nruntime: reference type is nil\nfile: ";
-                error += file;
-                jule::panic(error);
-#else
-                jule::panic(__JULE_ERROR__INVALID_MEMORY "\nruntime: reference type is nil");
+                                  , file
 #endif
-            }
+                );
         }
 
         Ptr& operator=(const jule::Ptr<T> &src) noexcept
@@ -283,6 +761,20 @@ namespace jule
             return *this;
         }
 
+        Ptr& operator=(jule::Ptr<T> &&src) noexcept
+        {
+            // Assignment to itself.
+            if (this == &src)
+                return *this;
+
+            this->dealloc();
+            this->alloc = src.alloc;
+            this->ref = src.ref;
+            src.alloc = nullptr;
+            src.ref = nullptr;
+            return *this;
+        }
+
         inline jule::Bool operator==(const std::nullptr_t &) const noexcept
         {
             return this->alloc == nullptr;
@@ -323,11 +815,7 @@ namespace jule
     template <typename T>
     inline jule::Ptr<T> new_ptr(const T &init) noexcept
     {
-#ifdef __JULE_DISABLE__REFERENCE_COUNTING
-        return jule::Ptr<T>::make(init, nullptr);
-#else
         return jule::Ptr<T>::make(init);
-#endif
     }
 
 } // namespace jule
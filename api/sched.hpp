@@ -0,0 +1,852 @@
+// Copyright 2024 The Jule Programming Language.
+// Use of this source code is governed by a BSD 3-Clause
+// license that can be found in the LICENSE file.
+
+#ifndef __JULE_SCHED_HPP
+#define __JULE_SCHED_HPP
+
+#include <new>
+#include <deque>
+#include <mutex>
+#include <queue>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <memory>
+#include <vector>
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+#include <functional>
+#include <condition_variable>
+
+#include "platform.hpp"
+#include "types.hpp"
+#include "error.hpp"
+#include "panic.hpp"
+#include "fn.hpp"
+
+#ifdef __JULE_GREEN_THREADS
+#include <signal.h>
+#include <ucontext.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+// Environment variable of maximum count of worker threads.
+#define __JULE_ENV_MAX_PROCS "JULE_MAX_PROCS"
+
+// Environment variable of stack size of green threads in bytes.
+#define __JULE_ENV_STACK_SIZE "JULE_STACK_SIZE"
+
+#define __JULE_CO(EXPR) \
+    (jule::sched_submit([=](void) mutable -> void { EXPR; }))
+
+namespace jule
+{
+
+    // Task of scheduler.
+    using Task = jule::Fn<void(void)>;
+
+    // Lightweight thread of concurrent call.
+    // Green threads are multiplexed on workers and have their own stacks,
+    // so blocking operations of runtime park green thread instead of
+    // holding worker.
+    struct Green;
+
+    // Work-stealing scheduler of concurrent calls.
+    // Each worker has its own deque. Worker takes green threads from back
+    // of its deque and steals from front of deques of other workers if own
+    // deque is empty. Green threads submitted by workers are pushed to deque
+    // of worker, others are distributed to deques of workers in round-robin
+    // order.
+    //
+    // Count of workers is fixed, concurrent calls are not OS threads.
+    // Concurrent call which blocks its worker without parking, such as
+    // spin-wait, polling or blocking call of C++ or IO, holds worker until
+    // it returns and may starve other concurrent calls. Such calls should
+    // run by jule::sched_blocking.
+    class Scheduler;
+
+    // Counting semaphore of runtime.
+    // Acquire parks caller green thread, or blocks caller OS thread if caller
+    // is not green thread. Release hands permit to waiter directly.
+    class Sema;
+
+    // Returns scheduler, starts workers at first call.
+    inline jule::Scheduler &sched(void) noexcept;
+
+    // Submits task to scheduler.
+    template <typename F>
+    inline void sched_submit(F &&f) noexcept;
+
+    // Returns green thread of caller, nullptr if caller is not green thread.
+    inline jule::Green *green_current(void) noexcept;
+
+    // Parks caller green thread. Mutex is unlocked after green thread is
+    // switched out, so waker which holds mutex cannot resume green thread
+    // before it is parked.
+    inline void green_park(std::mutex &mutex) noexcept;
+
+    // Makes parked green thread runnable.
+    inline void green_ready(jule::Green *g) noexcept;
+
+    // Yields processor of caller green thread to other green threads.
+    // Has no effect if caller is not green thread.
+    inline void sched_yield(void) noexcept;
+
+    // Stops execution of caller by nanoseconds.
+    // Parks caller if caller is green thread, blocks OS thread otherwise.
+    inline void sched_sleep(jule::U64 ns) noexcept;
+
+    // Runs function which may block, without holding worker of caller.
+    // Green threads park until function returns on a spare thread. Tasks
+    // which run on stacks of workers hand off worker to a spare thread
+    // until function returns. Spare threads are reused. Runs function
+    // directly if caller is not concurrent call.
+    template <typename F>
+    inline void sched_blocking(F &&f) noexcept;
+
+    // Returns count of workers.
+    // Uses __JULE_ENV_MAX_PROCS if set to a positive number,
+    // hardware concurrency otherwise.
+    inline jule::Uint sched_procs(void) noexcept
+    {
+        const char *env = std::getenv(__JULE_ENV_MAX_PROCS);
+        if (env)
+        {
+            const long n = std::strtol(env, nullptr, 10);
+            if (n > 0)
+                return static_cast<jule::Uint>(n);
+        }
+        const unsigned int n = std::thread::hardware_concurrency();
+        return n > 0 ? n : 1;
+    }
+
+    // Time to wait for semaphore before worker of caller is handed off.
+    // Short waits, such as waits of contended mutexes, do not hand off.
+    constexpr std::chrono::microseconds SCHED_HANDOFF_DELAY{50};
+
+#ifdef __JULE_GREEN_THREADS
+    // Default virtual size of stacks of green threads, same as default
+    // stack size of threads. Pages are committed when touched, so stacks
+    // grow in physical memory as used.
+#ifdef ARCH_X32
+    constexpr std::size_t GREEN_STACK_SIZE = 1 << 20;
+#else
+    constexpr std::size_t GREEN_STACK_SIZE = 8 << 20;
+#endif
+
+    // Minimum stack size of green threads.
+    constexpr std::size_t GREEN_STACK_MIN = 64 << 10;
+
+    // Size of inaccessible guard below stacks of green threads.
+    // Larger than a page, so large frames do not skip it.
+    constexpr std::size_t GREEN_STACK_GUARD = 64 << 10;
+
+    // Size of signal stack of workers, stack overflow is handled on it.
+    constexpr std::size_t GREEN_SIGNAL_STACK = 64 << 10;
+
+    // Maximum count of cached stacks of finished green threads.
+    constexpr std::size_t GREEN_STACK_CACHE = 64;
+
+    // Returns stack size of green threads.
+    // Uses __JULE_ENV_STACK_SIZE if set to a positive number,
+    // jule::GREEN_STACK_SIZE otherwise. Rounded up to page size.
+    inline std::size_t green_stack_size(void) noexcept
+    {
+        std::size_t size = jule::GREEN_STACK_SIZE;
+        const char *env = std::getenv(__JULE_ENV_STACK_SIZE);
+        if (env)
+        {
+            const long long n = std::strtoll(env, nullptr, 10);
+            if (n > 0)
+                size = static_cast<std::size_t>(n);
+        }
+        if (size < jule::GREEN_STACK_MIN)
+            size = jule::GREEN_STACK_MIN;
+        const std::size_t page = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+        return (size + page - 1) / page * page;
+    }
+#endif // __JULE_GREEN_THREADS
+
+    struct Green
+    {
+    public:
+        jule::Task task;
+#ifdef __JULE_GREEN_THREADS
+        ucontext_t ctx;
+        // Context of worker which runs green thread.
+        ucontext_t *worker = nullptr;
+        // Mapping of stack, starts with guard.
+        void *stack = nullptr;
+        // Mutex to unlock after parked.
+        std::mutex *unlock = nullptr;
+#ifdef __JULE_ENABLE__BIASED_REFERENCE_COUNTING
+        // Owner of blocks allocated by green thread, nullptr until first
+        // allocation. Blocks are not owned by workers, green threads may
+        // migrate between them.
+        jule::RcThread *rc = nullptr;
+#endif
+        jule::Bool parked = false;
+        jule::Bool done = false;
+#endif
+
+        Green(jule::Task &&task) noexcept : task(std::move(task)) {}
+    };
+
+    struct SchedWorker
+    {
+    public:
+        std::mutex mutex;
+        std::deque<jule::Green *> greens;
+#ifdef __JULE_GREEN_THREADS
+        ucontext_t ctx;
+#endif
+
+        inline void push(jule::Green *g)
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            this->greens.push_back(g);
+        }
+
+        // Pushes yielded green thread to front, so owner worker takes it
+        // after other green threads.
+        inline void push_front(jule::Green *g)
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            this->greens.push_front(g);
+        }
+
+        // Pops green thread from back, used by owner worker.
+        inline jule::Green *pop(void)
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            if (this->greens.empty())
+                return nullptr;
+            jule::Green *g = this->greens.back();
+            this->greens.pop_back();
+            return g;
+        }
+
+        // Steals green thread from front, used by other workers.
+        inline jule::Green *steal(void)
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            if (this->greens.empty())
+                return nullptr;
+            jule::Green *g = this->greens.front();
+            this->greens.pop_front();
+            return g;
+        }
+    };
+
+    // Sleeping green threads, resumed by timer thread at deadline.
+    struct SchedTimer
+    {
+    public:
+        using Clock = std::chrono::steady_clock;
+        using Entry = std::pair<Clock::time_point, jule::Green *>;
+
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> sleeping;
+
+        void run(void)
+        {
+            std::unique_lock<std::mutex> lock(this->mutex);
+            for (;;)
+            {
+                if (this->sleeping.empty())
+                {
+                    this->wake.wait(lock);
+                    continue;
+                }
+                const Clock::time_point deadline = this->sleeping.top().first;
+                if (Clock::now() < deadline)
+                {
+                    this->wake.wait_until(lock, deadline);
+                    continue;
+                }
+                jule::Green *g = this->sleeping.top().second;
+                this->sleeping.pop();
+                jule::green_ready(g);
+            }
+        }
+    };
+
+    class Scheduler
+    {
+    private:
+        jule::SchedWorker *workers = nullptr;
+        jule::Uint n = 0;
+        std::atomic<jule::Uint> next{0};
+
+        // Count of green threads which are queued but not taken.
+        std::atomic<jule::Int> pending{0};
+        // Count of parked workers.
+        std::atomic<jule::Int> parked{0};
+        std::atomic<jule::Bool> stopped{false};
+        std::mutex park_mutex;
+        std::condition_variable park;
+
+#ifdef __JULE_GREEN_THREADS
+        std::size_t stack_size = 0;
+        std::mutex stacks_mutex;
+        std::vector<void *> stacks;
+#endif
+
+        // Spare threads run blocking calls and handed off workers.
+        // Idle spare threads wait for jobs and are reused, at most count
+        // of workers of them stay idle, others exit after their job.
+        std::mutex spare_mutex;
+        std::condition_variable spare_wake;
+        std::deque<std::function<void()>> spare_jobs;
+        jule::Uint spare_idle = 0;
+
+        // Returns index of current worker, -1 if caller is not worker.
+        // Not inlined, green threads may migrate between workers and
+        // address of thread-local variable must not be cached.
+        __attribute__((noinline)) static jule::Int &current(void) noexcept
+        {
+            static thread_local jule::Int index = -1;
+            return index;
+        }
+
+        // Finds green thread for worker, own deque first, then steals.
+        jule::Green *find(jule::Uint index)
+        {
+            jule::Green *g = this->workers[index].pop();
+            if (g)
+                return g;
+            for (jule::Uint i = 1; i < this->n; ++i)
+            {
+                g = this->workers[(index + i) % this->n].steal();
+                if (g)
+                    return g;
+            }
+            return nullptr;
+        }
+
+#ifdef __JULE_GREEN_THREADS
+        void *new_stack(void) noexcept
+        {
+            {
+                std::lock_guard<std::mutex> lock(this->stacks_mutex);
+                if (!this->stacks.empty())
+                {
+                    void *stack = this->stacks.back();
+                    this->stacks.pop_back();
+                    return stack;
+                }
+            }
+            void *stack = mmap(nullptr, jule::GREEN_STACK_GUARD + this->stack_size, PROT_READ | PROT_WRITE,
+                               MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_STACK, -1, 0);
+            if (__JULE_UNLIKELY(stack == MAP_FAILED))
+                jule::panic_error(__JULE_ERROR__MEMORY_ALLOCATION_FAILED
+                                  "\nruntime: memory allocation failed for stack of green thread");
+            mprotect(stack, jule::GREEN_STACK_GUARD, PROT_NONE);
+            return stack;
+        }
+
+        void free_stack(void *stack) noexcept
+        {
+            // Release pages touched by deep calls before caching stack,
+            // cached stacks would hold them otherwise. Top of stack is kept,
+            // it is touched by every green thread.
+            if (this->stack_size > jule::GREEN_STACK_MIN)
+                madvise(static_cast<char *>(stack) + jule::GREEN_STACK_GUARD,
+                        this->stack_size - jule::GREEN_STACK_MIN, MADV_DONTNEED);
+            {
+                std::lock_guard<std::mutex> lock(this->stacks_mutex);
+                if (this->stacks.size() < jule::GREEN_STACK_CACHE)
+                {
+                    this->stacks.push_back(stack);
+                    return;
+                }
+            }
+            munmap(stack, jule::GREEN_STACK_GUARD + this->stack_size);
+        }
+
+        // Previous action of SIGSEGV, restored for faults which are not
+        // stack overflow of green threads.
+        static struct sigaction &fault_action(void) noexcept
+        {
+            static struct sigaction action;
+            return action;
+        }
+
+        // Reports stack overflow of green thread as panic.
+        // Runs on signal stack of worker, uses async-signal-safe calls only.
+        static void fault(int sig, siginfo_t *info, void *uctx) noexcept
+        {
+            (void)sig;
+            (void)uctx;
+            jule::Green *g = jule::Scheduler::running();
+            if (g && g->stack)
+            {
+                const char *addr = static_cast<const char *>(info->si_addr);
+                const char *guard = static_cast<const char *>(g->stack);
+                if (addr >= guard && addr < guard + jule::GREEN_STACK_GUARD)
+                {
+                    static const char message[] =
+                        "panic: " __JULE_ERROR__STACK_OVERFLOW
+                        "\nruntime: stack of concurrent call is exhausted, set "
+                        __JULE_ENV_STACK_SIZE " to increase stack size\n";
+                    (void)!write(STDERR_FILENO, message, sizeof(message) - 1);
+                    _exit(jule::EXIT_PANIC);
+                }
+            }
+            // Fault is raised again by previous action when handler returns.
+            sigaction(SIGSEGV, &jule::Scheduler::fault_action(), nullptr);
+        }
+
+        // Handles stack overflow of green threads.
+        void install_fault_handler(void) noexcept
+        {
+            struct sigaction action;
+            std::memset(&action, 0, sizeof(action));
+            action.sa_sigaction = &jule::Scheduler::fault;
+            action.sa_flags = SA_SIGINFO | SA_ONSTACK;
+            sigemptyset(&action.sa_mask);
+            sigaction(SIGSEGV, &action, &jule::Scheduler::fault_action());
+        }
+
+        // Sets signal stack of current worker.
+        // Overflowed stack of green thread cannot run signal handler.
+        static void set_signal_stack(void) noexcept
+        {
+            void *sp = mmap(nullptr, jule::GREEN_SIGNAL_STACK, PROT_READ | PROT_WRITE,
+                            MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (sp == MAP_FAILED)
+                return;
+            stack_t ss;
+            ss.ss_sp = sp;
+            ss.ss_size = jule::GREEN_SIGNAL_STACK;
+            ss.ss_flags = 0;
+            sigaltstack(&ss, nullptr);
+        }
+
+        static void entry(void) noexcept
+        {
+            jule::Green *g = jule::green_current();
+            g->task();
+            g->task = nullptr;
+            g->done = true;
+            swapcontext(&g->ctx, g->worker);
+        }
+
+        // Runs green thread until it is finished, parked or yielded.
+        void resume(jule::SchedWorker &worker, jule::Green *g) noexcept
+        {
+            if (!g->stack)
+            {
+                g->stack = this->new_stack();
+                getcontext(&g->ctx);
+                g->ctx.uc_stack.ss_sp = static_cast<char *>(g->stack) + jule::GREEN_STACK_GUARD;
+                g->ctx.uc_stack.ss_size = this->stack_size;
+                g->ctx.uc_link = nullptr;
+                makecontext(&g->ctx, &jule::Scheduler::entry, 0);
+            }
+            g->worker = &worker.ctx;
+            jule::Scheduler::running() = g;
+#ifdef __JULE_ENABLE__BIASED_REFERENCE_COUNTING
+            jule::RcThread *rc = jule::rc_thread_current();
+            jule::rc_thread_current() = g->rc;
+#endif
+            swapcontext(&worker.ctx, &g->ctx);
+            jule::Scheduler::running() = nullptr;
+#ifdef __JULE_ENABLE__BIASED_REFERENCE_COUNTING
+            g->rc = jule::rc_thread_current();
+            if (g->done && g->rc)
+                g->rc->drain();
+            jule::rc_thread_current() = rc;
+            if (g->done && g->rc)
+                jule::rc_thread_release(g->rc);
+#endif
+
+            if (g->done)
+            {
+                this->free_stack(g->stack);
+                delete g;
+                return;
+            }
+            if (g->parked)
+            {
+                // Green thread may be resumed by other worker after unlock.
+                std::mutex *unlock = g->unlock;
+                g->unlock = nullptr;
+                g->parked = false;
+                unlock->unlock();
+                return;
+            }
+            this->submit(g, true);
+        }
+#else
+        void resume(jule::SchedWorker &, jule::Green *g) noexcept
+        {
+            g->task();
+            delete g;
+        }
+#endif // __JULE_GREEN_THREADS
+
+        // Spare threads share deque of worker and return after released.
+        void run(jule::Uint index, std::shared_ptr<std::atomic<jule::Bool>> released = nullptr)
+        {
+            jule::Scheduler::current() = static_cast<jule::Int>(index);
+#ifdef __JULE_GREEN_THREADS
+            // Spare threads set their signal stack once, at start.
+            if (!released)
+                jule::Scheduler::set_signal_stack();
+#endif
+            jule::SchedWorker &worker = this->workers[index];
+            for (;;)
+            {
+                if (this->stopped.load() || (released && released->load()))
+                    return;
+                jule::Green *g = this->find(index);
+                if (g)
+                {
+                    this->pending.fetch_sub(1);
+                    this->resume(worker, g);
+                    continue;
+                }
+
+                // Worker may stay idle, merge blocks released to it.
+                jule::rc_thread_drain();
+                std::unique_lock<std::mutex> lock(this->park_mutex);
+                this->parked.fetch_add(1);
+                // Green thread may be submitted before worker is parked.
+                // Submitter notifies only if there is parked worker.
+                while (this->pending.load() <= 0 && !this->stopped.load() &&
+                       !(released && released->load()))
+                    this->park.wait(lock);
+                this->parked.fetch_sub(1);
+            }
+        }
+
+        void spare_run(void)
+        {
+#ifdef __JULE_GREEN_THREADS
+            jule::Scheduler::set_signal_stack();
+#endif
+            std::unique_lock<std::mutex> lock(this->spare_mutex);
+            for (;;)
+            {
+                this->spare_idle++;
+                while (this->spare_jobs.empty())
+                    this->spare_wake.wait(lock);
+                this->spare_idle--;
+                std::function<void()> job = std::move(this->spare_jobs.front());
+                this->spare_jobs.pop_front();
+                lock.unlock();
+                job();
+                job = nullptr;
+                lock.lock();
+                if (this->spare_idle >= this->n)
+                    return;
+            }
+        }
+
+    public:
+        jule::SchedTimer timer;
+
+        Scheduler(void) noexcept
+        {
+            this->n = jule::sched_procs();
+            this->workers = new (std::nothrow) jule::SchedWorker[this->n];
+            if (__JULE_UNLIKELY(!this->workers))
+                jule::panic_error(__JULE_ERROR__MEMORY_ALLOCATION_FAILED
+                                  "\nruntime: memory allocation failed for workers of scheduler");
+#ifdef __JULE_GREEN_THREADS
+            this->stack_size = jule::green_stack_size();
+            this->install_fault_handler();
+#endif
+            for (jule::Uint i = 0; i < this->n; ++i)
+                std::thread(&jule::Scheduler::run, this, i, nullptr).detach();
+#ifdef __JULE_GREEN_THREADS
+            std::thread(&jule::SchedTimer::run, &this->timer).detach();
+#endif
+        }
+
+        // Scheduler lives until process exit, workers are detached.
+        Scheduler(const jule::Scheduler &) = delete;
+        jule::Scheduler &operator=(const jule::Scheduler &) = delete;
+
+        // Returns green thread which is running by current worker.
+        // Not inlined for same reason with current.
+        __attribute__((noinline)) static jule::Green *&running(void) noexcept
+        {
+            static thread_local jule::Green *g = nullptr;
+            return g;
+        }
+
+        // Yielded green threads are queued behind others of worker.
+        void submit(jule::Green *g, const jule::Bool yielded = false)
+        {
+            const jule::Int index = jule::Scheduler::current();
+            if (index >= 0 && yielded)
+                this->workers[index].push_front(g);
+            else if (index >= 0)
+                this->workers[index].push(g);
+            else
+                this->workers[this->next.fetch_add(1, std::memory_order_relaxed) % this->n].push(g);
+            this->pending.fetch_add(1);
+            if (this->parked.load() > 0)
+            {
+                std::lock_guard<std::mutex> lock(this->park_mutex);
+                this->park.notify_one();
+            }
+        }
+
+        // Reports whether caller is worker or spare thread of worker.
+        static jule::Bool on_worker(void) noexcept
+        {
+            return jule::Scheduler::current() >= 0;
+        }
+
+        // Runs job on idle spare thread,
+        // starts new spare thread if there is no idle one.
+        void spare(std::function<void()> &&job)
+        {
+            std::lock_guard<std::mutex> lock(this->spare_mutex);
+            this->spare_jobs.push_back(std::move(job));
+            if (this->spare_idle >= this->spare_jobs.size())
+            {
+                this->spare_wake.notify_one();
+                return;
+            }
+            std::thread(&jule::Scheduler::spare_run, this).detach();
+        }
+
+        // Runs worker of caller on spare thread, so other tasks keep
+        // running while caller blocks. Spare thread returns to idle spares
+        // after flag is set by release. Caller must be worker.
+        std::shared_ptr<std::atomic<jule::Bool>> handoff(void)
+        {
+            const jule::Uint index = static_cast<jule::Uint>(jule::Scheduler::current());
+            std::shared_ptr<std::atomic<jule::Bool>> released =
+                std::make_shared<std::atomic<jule::Bool>>(false);
+            this->spare([this, index, released](void) -> void
+                        {
+                            this->run(index, released);
+                            jule::Scheduler::current() = -1; });
+            return released;
+        }
+
+        // Stops spare thread of handoff after its current task.
+        void release(const std::shared_ptr<std::atomic<jule::Bool>> &released) noexcept
+        {
+            released->store(true);
+            std::lock_guard<std::mutex> lock(this->park_mutex);
+            this->park.notify_all();
+        }
+
+        // Stops workers at exit of process.
+        // Running green threads are not interrupted, queued ones are not
+        // resumed, like detached threads which are not scheduled before exit.
+        void stop(void) noexcept
+        {
+            this->stopped.store(true);
+            std::lock_guard<std::mutex> lock(this->park_mutex);
+            this->park.notify_all();
+        }
+    };
+
+    inline jule::Scheduler &sched(void) noexcept
+    {
+        // Allocated once and never destroyed, so detached workers never
+        // access destroyed scheduler during exit.
+        static jule::Scheduler *sched = []
+        {
+            jule::Scheduler *sched = new (std::nothrow) jule::Scheduler;
+            if (__JULE_UNLIKELY(!sched))
+                jule::panic_error(__JULE_ERROR__MEMORY_ALLOCATION_FAILED
+                                  "\nruntime: memory allocation failed for scheduler");
+            std::atexit([]
+                        { jule::sched().stop(); });
+            return sched;
+        }();
+        return *sched;
+    }
+
+    template <typename F>
+    inline void sched_submit(F &&f) noexcept
+    {
+        jule::rc_thread_drain();
+        jule::Green *g = new (std::nothrow) jule::Green(jule::Task(std::forward<F>(f)));
+        if (__JULE_UNLIKELY(!g))
+            jule::panic_error(__JULE_ERROR__MEMORY_ALLOCATION_FAILED
+                              "\nruntime: memory allocation failed for green thread");
+        jule::sched().submit(g);
+    }
+
+    inline jule::Green *green_current(void) noexcept
+    {
+#ifdef __JULE_GREEN_THREADS
+        return jule::Scheduler::running();
+#else
+        return nullptr;
+#endif
+    }
+
+    inline void green_park(std::mutex &mutex) noexcept
+    {
+#ifdef __JULE_GREEN_THREADS
+        jule::Green *g = jule::green_current();
+        g->unlock = &mutex;
+        g->parked = true;
+        swapcontext(&g->ctx, g->worker);
+#else
+        (void)mutex;
+#endif
+    }
+
+    inline void green_ready(jule::Green *g) noexcept
+    {
+        jule::sched().submit(g);
+    }
+
+    inline void sched_yield(void) noexcept
+    {
+#ifdef __JULE_GREEN_THREADS
+        jule::Green *g = jule::green_current();
+        if (g)
+        {
+            jule::rc_thread_drain();
+            swapcontext(&g->ctx, g->worker);
+        }
+#endif
+    }
+
+    inline void sched_sleep(jule::U64 ns) noexcept
+    {
+        jule::rc_thread_drain();
+#ifdef __JULE_GREEN_THREADS
+        jule::Green *g = jule::green_current();
+        if (g)
+        {
+            jule::SchedTimer &timer = jule::sched().timer;
+            const jule::SchedTimer::Clock::time_point deadline =
+                jule::SchedTimer::Clock::now() + std::chrono::nanoseconds(ns);
+            timer.mutex.lock();
+            timer.sleeping.push(jule::SchedTimer::Entry(deadline, g));
+            timer.wake.notify_one();
+            jule::green_park(timer.mutex);
+            return;
+        }
+#endif
+        std::this_thread::sleep_for(std::chrono::nanoseconds(ns));
+    }
+
+    class Sema
+    {
+    private:
+        struct Waiter
+        {
+        public:
+            jule::Green *g = nullptr;
+            std::condition_variable *cv = nullptr;
+            jule::Bool woken = false;
+        };
+
+        std::mutex mutex;
+        jule::Uint count = 0;
+        std::deque<Waiter *> waiters;
+
+    public:
+        Sema(void) = default;
+        Sema(const jule::Sema &) = delete;
+        jule::Sema &operator=(const jule::Sema &) = delete;
+
+        void acquire(void) noexcept
+        {
+            // Caller may be parked or blocked for a long time.
+            jule::rc_thread_drain();
+            this->mutex.lock();
+            if (this->count > 0)
+            {
+                this->count--;
+                this->mutex.unlock();
+                return;
+            }
+            Waiter w;
+            w.g = jule::green_current();
+            this->waiters.push_back(&w);
+            if (w.g)
+            {
+                // Released permit is handed over by release.
+                jule::green_park(this->mutex);
+                return;
+            }
+            std::condition_variable cv;
+            w.cv = &cv;
+            std::unique_lock<std::mutex> lock(this->mutex, std::adopt_lock);
+            // Tasks which run on stacks of workers cannot park,
+            // worker is handed off if task blocks longer than delay.
+            std::shared_ptr<std::atomic<jule::Bool>> released;
+            if (jule::Scheduler::on_worker() &&
+                !cv.wait_for(lock, jule::SCHED_HANDOFF_DELAY, [&w]
+                             { return w.woken; }))
+                released = jule::sched().handoff();
+            while (!w.woken)
+                cv.wait(lock);
+            lock.unlock();
+            if (released)
+                jule::sched().release(released);
+        }
+
+        void release(void) noexcept
+        {
+            this->mutex.lock();
+            if (this->waiters.empty())
+            {
+                this->count++;
+                this->mutex.unlock();
+                return;
+            }
+            Waiter *w = this->waiters.front();
+            this->waiters.pop_front();
+            w->woken = true;
+            if (w->g)
+            {
+                // Waiter is parked, it cannot be resumed before ready.
+                jule::Green *g = w->g;
+                this->mutex.unlock();
+                jule::green_ready(g);
+                return;
+            }
+            // Notify before unlock, waiter owns condition variable.
+            w->cv->notify_one();
+            this->mutex.unlock();
+        }
+    };
+
+    template <typename F>
+    inline void sched_blocking(F &&f) noexcept
+    {
+#ifdef __JULE_GREEN_THREADS
+        if (jule::green_current())
+        {
+            jule::Sema done;
+            jule::sched().spare([&](void) -> void
+                                {
+                                    f();
+                                    done.release(); });
+            done.acquire();
+            return;
+        }
+#endif
+        if (!jule::Scheduler::on_worker())
+        {
+            f();
+            return;
+        }
+        std::shared_ptr<std::atomic<jule::Bool>> released = jule::sched().handoff();
+        f();
+        jule::sched().release(released);
+    }
+
+} // namespace jule
+
+#endif // ifndef __JULE_SCHED_HPP
@@ -6,35 +6,185 @@
 #define __JULE_SLICE_HPP
 
 #include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <new>
 #include <sstream>
 #include <ostream>
 #include <initializer_list>
+#include <utility>
+#include <type_traits>
 
 #include "panic.hpp"
 #include "error.hpp"
 #include "ptr.hpp"
 #include "types.hpp"
 
+// Growth of slice capacity in percent of required length.
+#ifndef __JULE_SLICE_GROWTH
+#define __JULE_SLICE_GROWTH 200
+#endif
+
+// Growth of slice capacity in percent of required length for large
+// slices, which are require __JULE_SLICE_LARGE_THRESHOLD bytes at least.
+#ifndef __JULE_SLICE_LARGE_GROWTH
+#define __JULE_SLICE_LARGE_GROWTH 150
+#endif
+
+#ifndef __JULE_SLICE_LARGE_THRESHOLD
+#define __JULE_SLICE_LARGE_THRESHOLD (1 << 20)
+#endif
+
 namespace jule
 {
 
+    // Control block of slice allocations.
+    // Elements are stored right after the block, in the same allocation.
+    template <typename Item>
+    struct SliceBlock;
+
     // Built-in slice type.
     template <typename Item>
     class Slice;
 
+    template <typename Item>
+    struct SliceBlock : public jule::RefBlock
+    {
+        jule::Int cap;
+
+        // Count of constructed elements.
+        // Elements [0, len) are constructed, rest of capacity is raw memory.
+        jule::Int len;
+
+        // Returns offset of elements from beginning of allocation.
+        static constexpr std::size_t offset(void) noexcept
+        {
+            return (sizeof(jule::SliceBlock<Item>) + alignof(Item) - 1) / alignof(Item) * alignof(Item);
+        }
+
+        // Returns maximum capacity which can be allocated.
+        static constexpr jule::Int max_cap(void) noexcept
+        {
+            return (SIZE_MAX - offset()) / sizeof(Item) <
+                           static_cast<std::size_t>(std::numeric_limits<jule::Int>::max())
+                       ? static_cast<jule::Int>((SIZE_MAX - offset()) / sizeof(Item))
+                       : std::numeric_limits<jule::Int>::max();
+        }
+
+        // Panics for capacity which cannot be allocated.
+        static void overflow(void) noexcept
+        {
+            jule::panic_error(__JULE_ERROR__MEMORY_ALLOCATION_FAILED
+                              "\nruntime: slice capacity is too large");
+        }
+
+        inline Item *items(void) noexcept
+        {
+            return reinterpret_cast<Item *>(reinterpret_cast<jule::U8 *>(this) +
+                                            jule::SliceBlock<Item>::offset());
+        }
+
+        // Allocates block with capacity for cap elements.
+        // Elements are not constructed.
+        // Panics if capacity exceeds jule::SliceBlock::max_cap.
+        static jule::SliceBlock<Item> *alloc(const jule::Int &cap) noexcept
+        {
+            constexpr jule::Int max_cap = jule::SliceBlock<Item>::max_cap();
+            if (__JULE_UNLIKELY(cap > max_cap))
+                jule::SliceBlock<Item>::overflow();
+            void *alloc = std::malloc(jule::SliceBlock<Item>::offset() + cap * sizeof(Item));
+            if (__JULE_UNLIKELY(!alloc))
+                jule::panic_error(__JULE_ERROR__MEMORY_ALLOCATION_FAILED
+                                  "\nruntime: heap allocation failed of slice");
+
+            jule::SliceBlock<Item> *block = new (alloc) jule::SliceBlock<Item>;
+            block->destroy = jule::SliceBlock<Item>::destroy_block;
+            block->cap = cap;
+            block->len = 0;
+            return block;
+        }
+
+        // Reallocates block with capacity for cap elements.
+        // Elements are relocated by realloc, so elements must be trivially
+        // copyable and block must not be referenced by anything else.
+        // Allocator may extend block in place or remap its pages.
+        static jule::SliceBlock<Item> *realloc(jule::SliceBlock<Item> *block,
+                                               const jule::Int &cap) noexcept
+        {
+            constexpr jule::Int max_cap = jule::SliceBlock<Item>::max_cap();
+            if (__JULE_UNLIKELY(cap > max_cap))
+                jule::SliceBlock<Item>::overflow();
+            void *alloc = std::realloc(static_cast<void *>(block),
+                                       jule::SliceBlock<Item>::offset() + cap * sizeof(Item));
+            if (__JULE_UNLIKELY(!alloc))
+                jule::panic_error(__JULE_ERROR__MEMORY_ALLOCATION_FAILED
+                                  "\nruntime: heap allocation failed of slice");
+
+            block = static_cast<jule::SliceBlock<Item> *>(alloc);
+            block->cap = cap;
+            return block;
+        }
+
+        // Constructs element at index if index is end of constructed
+        // elements, assigns otherwise.
+        template <typename T>
+        inline void put(const jule::Int &index, T &&item)
+        {
+            Item *p = this->items() + index;
+            if (index < this->len)
+            {
+                *p = std::forward<T>(item);
+                return;
+            }
+            new (p) Item(std::forward<T>(item));
+            this->len = index + 1;
+        }
+
+        static void destroy_block(jule::RefBlock *block) noexcept
+        {
+            jule::SliceBlock<Item> *slice_block = static_cast<jule::SliceBlock<Item> *>(block);
+            Item *items = slice_block->items();
+            for (jule::Int i = 0; i < slice_block->len; ++i)
+                items[i].~Item();
+            slice_block->~SliceBlock<Item>();
+            std::free(static_cast<void *>(slice_block));
+        }
+    };
+
+    // Returns capacity for growing slice to hold n elements.
+    // Panics if n exceeds jule::SliceBlock::max_cap,
+    // capacity is limited by jule::SliceBlock::max_cap.
+    template <typename Item>
+    inline jule::Int slice_growth(const jule::Int &n) noexcept
+    {
+        constexpr jule::Int max_cap = jule::SliceBlock<Item>::max_cap();
+        if (__JULE_UNLIKELY(n > max_cap))
+            jule::SliceBlock<Item>::overflow();
+        const jule::Int growth = n < __JULE_SLICE_LARGE_THRESHOLD / static_cast<jule::Int>(sizeof(Item))
+                                     ? __JULE_SLICE_GROWTH
+                                     : __JULE_SLICE_LARGE_GROWTH;
+        if (growth > 100 && n / 100 >= (max_cap - n) / (growth - 100))
+            return max_cap;
+        const jule::Int cap = n + n / 100 * (growth - 100) + n % 100 * (growth - 100) / 100;
+        return cap < n ? n : cap;
+    }
+
     template <typename Item>
     class Slice
     {
     public:
-        mutable jule::Ptr<Item> data;
+        // Control block of buffer which holds reference counter and base
+        // of elements. Slice does not own its buffer if block is nullptr.
+        // Capacity is computed by block, so header is three words.
+        mutable jule::SliceBlock<Item> *_block = nullptr;
         mutable Item *_slice = nullptr;
         mutable jule::Int _len = 0;
-        mutable jule::Int _cap = 0;
 
         static jule::Slice<Item> alloc(const jule::Int &len) noexcept
         {
-            if (len < 0)
-                jule::panic("runtime: []T: slice allocation length lower than zero");
+            if (__JULE_UNLIKELY(len < 0))
+                jule::panic_error("runtime: []T: slice allocation length lower than zero");
 
             jule::Slice<Item> buffer;
             buffer.alloc_new(len, len, Item());
@@ -43,12 +193,12 @@ namespace jule
 
         static jule::Slice<Item> alloc(const jule::Int &len, const jule::Int &cap) noexcept
         {
-            if (len < 0)
-                jule::panic("runtime: []T: slice allocation length lower than zero");
-            if (cap < 0)
-                jule::panic("runtime: []T: slice allocation capacity lower than zero");
-            if (len > cap)
-                jule::panic("runtime: []T: slice allocation length greater than capacity");
+            if (__JULE_UNLIKELY(len < 0))
+                jule::panic_error("runtime: []T: slice allocation length lower than zero");
+            if (__JULE_UNLIKELY(cap < 0))
+                jule::panic_error("runtime: []T: slice allocation capacity lower than zero");
+            if (__JULE_UNLIKELY(len > cap))
+                jule::panic_error("runtime: []T: slice allocation length greater than capacity");
 
             jule::Slice<Item> buffer;
             buffer.alloc_new(len, cap, Item());
@@ -57,8 +207,8 @@ namespace jule
 
         static jule::Slice<Item> alloc_def(const jule::Int &len, const Item &def) noexcept
         {
-            if (len < 0)
-                jule::panic("runtime: []T: slice allocation length lower than zero");
+            if (__JULE_UNLIKELY(len < 0))
+                jule::panic_error("runtime: []T: slice allocation length lower than zero");
 
             jule::Slice<Item> buffer;
             buffer.alloc_new(len, len, def);
@@ -67,12 +217,12 @@ namespace jule
 
         static jule::Slice<Item> alloc(const jule::Int &len, const jule::Int &cap, const Item &def) noexcept
         {
-            if (len < 0)
-                jule::panic("runtime: []T: slice allocation length lower than zero");
-            if (cap < 0)
-                jule::panic("runtime: []T: slice allocation capacity lower than zero");
-            if (len > cap)
-                jule::panic("runtime: []T: slice allocation length greater than capacity");
+            if (__JULE_UNLIKELY(len < 0))
+                jule::panic_error("runtime: []T: slice allocation length lower than zero");
+            if (__JULE_UNLIKELY(cap < 0))
+                jule::panic_error("runtime: []T: slice allocation capacity lower than zero");
+            if (__JULE_UNLIKELY(len > cap))
+                jule::panic_error("runtime: []T: slice allocation length greater than capacity");
 
             jule::Slice<Item> buffer;
             buffer.alloc_new(len, cap, def);
@@ -88,8 +238,11 @@ namespace jule
         }
 
         Slice(jule::Slice<Item> &&src) noexcept
+            : _block(src._block), _slice(src._slice), _len(src._len)
         {
-            this->__get_copy(src);
+            src._block = nullptr;
+            src._slice = nullptr;
+            src._len = 0;
         }
 
         Slice(const std::initializer_list<Item> &src)
@@ -97,10 +250,9 @@ namespace jule
             if (src.size() == 0)
                 return;
 
-            this->alloc_new(src.size(), src.size());
-            const auto src_begin = src.begin();
-            for (jule::Int i = 0; i < this->_len; ++i)
-                this->data.alloc[i] = *static_cast<const Item *>(src_begin + i);
+            this->alloc_new(0, src.size());
+            for (const Item &item : src)
+                this->__push(item);
         }
 
         ~Slice(void) noexcept
@@ -114,10 +266,14 @@ namespace jule
             if (src == nullptr)
                 return;
 
-            this->_len = src._len;
-            this->_cap = src._cap;
-            this->data = src.data;
+#ifndef __JULE_DISABLE__REFERENCE_COUNTING
+            if (src._block)
+                jule::add_ref(&src._block->n);
+#endif
+
+            this->_block = src._block;
             this->_slice = src._slice;
+            this->_len = src._len;
         }
 
         inline void check(
@@ -126,55 +282,42 @@ namespace jule
 #endif
         ) const noexcept
         {
-            if (this->operator==(nullptr))
-            {
+            if (__JULE_UNLIKELY(this->operator==(nullptr)))
+                jule::panic_error(__JULE_ERROR__INVALID_MEMORY "\nruntime: slice is nil"
 #ifndef __JULE_ENABLE__PRODUCTION
-                std::string error = __JULE_ERROR__INVALID_MEMORY "\nruntime: slice is nil\nfile: ";
-                error += file;
-                jule::panic(error);
-#else
-                jule::panic(__JULE_ERROR__INVALID_MEMORY "\nruntime: slice is nil");
+                                  , file
 #endif
-            }
+                );
         }
 
         // Frees memory. Unsafe function, not includes any safety checking for
         // heap allocations are valid or something like that.
         void __free(void) noexcept
         {
-            delete this->data.ref;
-            this->data.ref = nullptr;
-
-            delete[] this->data.alloc;
-            this->data.alloc = nullptr;
+            // Slices without control block do not own their buffer.
+            if (this->_block)
+                this->_block->destroy(this->_block);
+            this->_block = nullptr;
             this->_slice = nullptr;
         }
 
         void dealloc(void) noexcept
         {
-#ifdef __JULE_DISABLE__REFERENCE_COUNTING
             this->_len = 0;
-            this->_cap = 0;
-            this->data.dealloc();
+#ifdef __JULE_DISABLE__REFERENCE_COUNTING
+            this->_block = nullptr;
+            this->_slice = nullptr;
 #else
-            this->_len = 0;
-            this->_cap = 0;
-
-            if (!this->data.ref)
+            if (!this->_block)
             {
-                this->data.alloc = nullptr;
+                this->_slice = nullptr;
                 return;
             }
 
-            // Use jule::REFERENCE_DELTA, DON'T USE drop_ref METHOD BECAUSE
-            // jule_ref does automatically this.
-            // If not in this case:
-            //   if this is method called from destructor, reference count setted to
-            //   negative integer but reference count is unsigned, for this reason
-            //   allocation is not deallocated.
-            if (this->data.get_ref_n() != jule::REFERENCE_DELTA)
+            if (jule::drop_ref(&this->_block->n) != jule::REFERENCE_DELTA)
             {
-                this->data.alloc = nullptr;
+                this->_block = nullptr;
+                this->_slice = nullptr;
                 return;
             }
 
@@ -182,32 +325,35 @@ namespace jule
 #endif // __JULE_DISABLE__REFERENCE_COUNTING
         }
 
+        // Allocates new buffer with cap capacity.
+        // First len elements are default-initialized, rest of
+        // capacity is constructed by appends.
         void alloc_new(const jule::Int &len, const jule::Int &cap)
         {
-            this->dealloc();
-
-            Item *alloc = new (std::nothrow) Item[cap];
-            if (!alloc)
-                jule::panic(__JULE_ERROR__MEMORY_ALLOCATION_FAILED
-                            "\nruntime: heap allocation failed of slice");
-
-#ifdef __JULE_DISABLE__REFERENCE_COUNTING
-            this->data = jule::Ptr<Item>::make(alloc, nullptr);
-#else
-            this->data = jule::Ptr<Item>::make(alloc);
-#endif
+            jule::SliceBlock<Item> *block = this->__alloc_block(cap);
+            Item *items = block->items();
+            for (; block->len < len; ++block->len)
+                new (items + block->len) Item();
             this->_len = len;
-            this->_cap = cap;
-            this->_slice = alloc;
         }
 
         void alloc_new(const jule::Int &len, const jule::Int &cap, const Item &def) noexcept
         {
-            this->alloc_new(len, cap);
+            jule::SliceBlock<Item> *block = this->__alloc_block(cap);
+            Item *items = block->items();
+            for (; block->len < len; ++block->len)
+                new (items + block->len) Item(def);
+            this->_len = len;
+        }
 
-            // Initialize elements.
-            for (jule::Int i = 0; i < len; ++i)
-                *(this->_slice + i) = def;
+        // Releases buffer and sets new empty block with cap capacity.
+        jule::SliceBlock<Item> *__alloc_block(const jule::Int &cap)
+        {
+            this->dealloc();
+
+            this->_block = jule::SliceBlock<Item>::alloc(cap);
+            this->_slice = this->_block->items();
+            return this->_block;
         }
 
         using Iterator = Item*;
@@ -247,23 +393,18 @@ namespace jule
                     file
 #endif
                 );
-            if (start < 0 || end < 0 || start > end || end > this->_len)
-            {
-                std::string error;
-                __JULE_WRITE_ERROR_SLICING_INDEX_OUT_OF_RANGE(error, start, end, this->len());
-                error += "\nruntime: slice slicing with out of range indexes";
+            if (__JULE_UNLIKELY(start < 0 || end < 0 || start > end || end > this->_len))
+                jule::panic_slicing("\nruntime: slice slicing with out of range indexes",
+                                    start, end, this->len()
 #ifndef __JULE_ENABLE__PRODUCTION
-                error += "\nfile: ";
-                error += file;
+                                    , file
 #endif
-                jule::panic(error);
-            }
+                );
 #endif
             jule::Slice<Item> slice;
-            slice.data = this->data;
+            slice.__get_copy(*this);
             slice._slice = this->_slice + start;
             slice._len = end - start;
-            slice._cap = this->_cap - start;
             return slice;
         }
 
@@ -301,39 +442,87 @@ namespace jule
             return this->_len;
         }
 
-        constexpr jule::Int cap(void) const noexcept
+        // Returns capacity, which is rest of block from first element.
+        // Capacity of slice which does not own its buffer is its length.
+        inline jule::Int cap(void) const noexcept
         {
-            return this->_cap;
+            if (!this->_block)
+                return this->_len;
+            return this->_block->cap - (this->_slice - this->_block->items());
         }
 
         inline jule::Bool empty(void) const noexcept
         {
-            return !this->_slice || this->_len == 0 || this->_cap == 0;
+            return !this->_slice || this->_len == 0;
         }
 
         // Push item to last without allocation checks.
-        inline void __push(const Item &item)
+        // Capacity out of constructed elements is constructed by item.
+        template <typename T>
+        inline void __push(T &&item)
+        {
+            if (this->_block)
+                this->_block->put((this->_slice - this->_block->items()) + this->_len, std::forward<T>(item));
+            else
+                this->_slice[this->_len] = std::forward<T>(item);
+            ++this->_len;
+        }
+
+        // Reallocates buffer with cap capacity, keeps elements.
+        // Elements are moved if buffer is not shared, copied otherwise.
+        // Unshared buffers of trivially copyable elements are reallocated.
+        void __realloc(const jule::Int &cap)
+        {
+#if !defined(__JULE_DISABLE__REFERENCE_COUNTING) && !defined(__JULE_ENABLE__BIASED_REFERENCE_COUNTING)
+            // Blocks of biased reference counting may be queued to owner
+            // thread, so they cannot be relocated.
+            if (std::is_trivially_copyable<Item>::value &&
+                this->_block && jule::get_ref_n(&this->_block->n) == jule::REFERENCE_DELTA)
+            {
+                const jule::Int offset = this->_slice - this->_block->items();
+                this->_block = jule::SliceBlock<Item>::realloc(this->_block, offset + cap);
+                this->_slice = this->_block->items() + offset;
+                return;
+            }
+#endif
+            jule::Slice<Item> _new;
+            jule::SliceBlock<Item> *block = _new.__alloc_block(cap);
+            Item *items = block->items();
+#ifndef __JULE_DISABLE__REFERENCE_COUNTING
+            if (this->_block && jule::get_ref_n(&this->_block->n) == jule::REFERENCE_DELTA)
+            {
+                for (; block->len < this->_len; ++block->len)
+                    new (items + block->len) Item(std::move(this->_slice[block->len]));
+            }
+            else
+#endif
+            {
+                for (; block->len < this->_len; ++block->len)
+                    new (items + block->len) Item(this->_slice[block->len]);
+            }
+            _new._len = this->_len;
+            this->operator=(std::move(_new));
+        }
+
+        // Grows buffer if capacity is not enough to append n elements.
+        inline void __reserve_append(const jule::Int &n)
         {
-            this->_slice[this->_len++] = item;
+            if (this->_len + n > this->cap())
+                this->__realloc(jule::slice_growth<Item>(this->_len + n));
         }
 
-        void push(const Item &item)
+        template <typename T>
+        void push(T &&item)
         {
-            if (this->_len == this->_cap)
+            if (this->_len == this->cap())
             {
-                jule::Slice<Item> _new;
-                _new.alloc_new(this->_len + 1, (this->_len + 1) * 2);
-                std::move(
-                    this->_slice,
-                    this->_slice + this->_len,
-                    _new._slice);
-                *(_new._slice + this->_len) = item;
-
-                this->operator=(_new);
+                // Item may be element of buffer.
+                Item tmp(std::forward<T>(item));
+                this->__realloc(jule::slice_growth<Item>(this->_len + 1));
+                this->__push(std::move(tmp));
                 return;
             }
-
-            this->__push(item);
+            this->__push(std::forward<T>(item));
         }
 
         jule::Bool operator==(const jule::Slice<Item> &src) const
@@ -366,20 +555,12 @@ namespace jule
         inline void swap(const jule::Int &i, const jule::Int &j) const noexcept
         {
 #ifndef __JULE_DISABLE__SAFETY
-            if (this->empty() || i < 0 || this->len() <= i)
-            {
-                std::string error;
-                __JULE_WRITE_ERROR_INDEX_OUT_OF_RANGE(error, i, this->len());
-                error += "\nruntime: slice element swapping with out of range index";
-                jule::panic(error);
-            }
-            if (this->empty() || j < 0 || this->len() <= j)
-            {
-                std::string error;
-                __JULE_WRITE_ERROR_INDEX_OUT_OF_RANGE(error, j, this->len());
-                error += "\nruntime: slice element swapping with out of range index";
-                jule::panic(error);
-            }
+            if (__JULE_UNLIKELY(static_cast<jule::Uint>(i) >= static_cast<jule::Uint>(this->_len)))
+                jule::panic_index("\nruntime: slice element swapping with out of range index",
+                                  i, this->len());
+            if (__JULE_UNLIKELY(static_cast<jule::Uint>(j) >= static_cast<jule::Uint>(this->_len)))
+                jule::panic_index("\nruntime: slice element swapping with out of range index",
+                                  j, this->len());
 #endif
             std::swap(this->__at(i), this->__at(j));
         }
@@ -400,21 +581,21 @@ namespace jule
             const jule::Int &index) const noexcept
         {
 #ifndef __JULE_DISABLE__SAFETY
-            this->check(
+            // Single unsigned comparison covers negative indexes and nil
+            // slices, which have zero length.
+            if (__JULE_UNLIKELY(static_cast<jule::Uint>(index) >= static_cast<jule::Uint>(this->_len)))
+            {
+                this->check(
 #ifndef __JULE_ENABLE__PRODUCTION
-                file
+                    file
 #endif
-            );
-            if (this->empty() || index < 0 || this->len() <= index)
-            {
-                std::string error;
-                __JULE_WRITE_ERROR_INDEX_OUT_OF_RANGE(error, index, this->len());
-                error += "\nruntime: slice indexing with out of range index";
+                );
+                jule::panic_index("\nruntime: slice indexing with out of range index",
+                                  index, this->len()
 #ifndef __JULE_ENABLE__PRODUCTION
-                error += "\nfile: ";
-                error += file;
+                                  , file
 #endif
-                jule::panic(error);
+                );
             }
 #endif
             return this->__at(index);
@@ -432,11 +613,10 @@ namespace jule
         Slice& operator=(const jule::Slice<Item> &src) noexcept
         {
             // Assignment to itself.
-            if (this->data.alloc != nullptr && this->data.alloc == src.data.alloc)
+            if (this->_block != nullptr && this->_block == src._block)
             {
-                this->_len = src._len;
-                this->_cap = src._cap;
                 this->_slice = src._slice;
+                this->_len = src._len;
                 return *this;
             }
 
@@ -445,6 +625,22 @@ namespace jule
             return *this;
         }
 
+        Slice& operator=(jule::Slice<Item> &&src) noexcept
+        {
+            // Assignment to itself.
+            if (this == &src)
+                return *this;
+
+            this->dealloc();
+            this->_block = src._block;
+            this->_slice = src._slice;
+            this->_len = src._len;
+            src._block = nullptr;
+            src._slice = nullptr;
+            src._len = 0;
+            return *this;
+        }
+
         inline Slice& operator=(const std::nullptr_t) noexcept
         {
             this->dealloc();
@@ -41,6 +41,7 @@ namespace jule
 
         Str(void) = default;
         Str(const jule::Str &src) = default;
+        Str(jule::Str &&src) = default;
         Str(const std::initializer_list<jule::U8> &src) : buffer(src) {}
         Str(const jule::I32 &rune) : Str(jule::utf8_rune_to_bytes(rune)) {}
         Str(const std::basic_string<jule::U8> &src) : buffer(src) {}
@@ -92,17 +93,13 @@ namespace jule
             const jule::Int &end) const noexcept
         {
 #ifndef __JULE_DISABLE__SAFETY
-            if (start < 0 || end < 0 || start > end || end > this->len())
-            {
-                std::string error;
-                __JULE_WRITE_ERROR_SLICING_INDEX_OUT_OF_RANGE(error, start, end, this->len());
-                error += "\nruntime: string slicing with out of range indexes";
+            if (__JULE_UNLIKELY(start < 0 || end < 0 || start > end || end > this->len()))
+                jule::panic_slicing("\nruntime: string slicing with out of range indexes",
+                                    start, end, this->len()
 #ifndef __JULE_ENABLE__PRODUCTION
-                error += "\nfile:";
-                error += file;
+                                    , file
 #endif
-                jule::panic(error);
-            }
+                );
 #endif
             if (start == end)
                 return {};
@@ -207,17 +204,13 @@ namespace jule
             const jule::Int &index) noexcept
         {
 #ifndef __JULE_DISABLE__SAFETY
-            if (this->empty() || index < 0 || this->len() <= index)
-            {
-                std::string error;
-                __JULE_WRITE_ERROR_INDEX_OUT_OF_RANGE(error, index, this->len());
-                error += "\nruntime: string indexing with out of range index";
+            if (__JULE_UNLIKELY(static_cast<jule::Uint>(index) >= static_cast<jule::Uint>(this->len())))
+                jule::panic_index("\nruntime: string indexing with out of range index",
+                                  index, this->len()
 #ifndef __JULE_ENABLE__PRODUCTION
-                error += "\nfile: ";
-                error += file;
+                                  , file
 #endif
-                jule::panic(error);
-            }
+                );
 #endif
             return this->__at(index);
         }
@@ -231,6 +224,9 @@ namespace jule
 #endif
         }
 
+        jule::Str &operator=(const jule::Str &str) = default;
+        jule::Str &operator=(jule::Str &&str) = default;
+
         inline void operator+=(const jule::Str &str)
         {
             this->buffer += str.buffer;
@@ -6,9 +6,7 @@
 #define __JULE_TRAIT_HPP
 
 #include <string>
-#include <typeinfo>
 #include <ostream>
-#include <cstring>
 
 #include "types.hpp"
 #include "panic.hpp"
@@ -27,7 +25,7 @@ namespace jule
     {
     public:
         mutable jule::Ptr<Mask> data;
-        const char *type_id = nullptr;
+        jule::TypeId type = nullptr;
 
         Trait(void) = default;
         Trait(std::nullptr_t) : Trait() {}
@@ -35,30 +33,21 @@ namespace jule
         template <typename T>
         Trait(const T &data) noexcept
         {
-            T *alloc = new (std::nothrow) T;
-            if (!alloc)
-                jule::panic(__JULE_ERROR__MEMORY_ALLOCATION_FAILED "\nfile: /api/trait.hpp");
-
-            *alloc = data;
-#ifdef __JULE_DISABLE__REFERENCE_COUNTING
-            this->data = jule::Ptr<Mask>::make(static_cast<Mask *>(alloc), nullptr);
-#else
-            this->data = jule::Ptr<Mask>::make(static_cast<Mask *>(alloc));
-#endif
-            this->type_id = typeid(T).name();
+            // Control block destroys data as T, not as Mask.
+            jule::PtrBlock<T> *block = jule::new_ptr_block<T>(data);
+            this->data = jule::Ptr<Mask>::make(static_cast<Mask *>(&block->value), &block->n);
+            this->type = jule::type_id<T>();
         }
 
         template <typename T>
         Trait(const jule::Ptr<T> &ref) noexcept
         {
-#ifdef __JULE_DISABLE__REFERENCE_COUNTING
-            this->data = jule::Ptr<Mask>::make(static_cast<Mask *>(ref.alloc), nullptr);
-#else
             this->data = jule::Ptr<Mask>::make(static_cast<Mask *>(ref.alloc), ref.ref);
-            if (ref != nullptr)
+#ifndef __JULE_DISABLE__REFERENCE_COUNTING
+            if (ref.ref)
                 this->data.add_ref();
 #endif
-            this->type_id = typeid(ref).name();
+            this->type = jule::type_id<jule::Ptr<T>>();
         }
 
         Trait(const jule::Trait<Mask> &src) noexcept
@@ -67,8 +56,9 @@ namespace jule
         }
 
         Trait(jule::Trait<Mask> &&src) noexcept
+            : data(std::move(src.data)), type(src.type)
         {
-            this->__get_copy(src);
+            src.type = nullptr;
         }
 
         // Frees memory. Unsafe function, not includes any safety checking for
@@ -89,7 +79,7 @@ namespace jule
             if (src == nullptr)
                 return;
             this->data = src.data;
-            this->type_id = src.type_id;
+            this->type = src.type;
         }
 
         inline void must_ok(
@@ -100,25 +90,29 @@ namespace jule
 #endif
         ) const noexcept
         {
-            if (this->operator==(nullptr))
-            {
+            if (__JULE_UNLIKELY(this->operator==(nullptr)))
+                jule::panic_error(__JULE_ERROR__INVALID_MEMORY,
 #ifndef __JULE_ENABLE__PRODUCTION
-                std::string error = __JULE_ERROR__INVALID_MEMORY "\nfile: ";
-                error += file;
-                jule::panic(error);
+                                  file
 #else
-                jule::panic(__JULE_ERROR__INVALID_MEMORY "\nfile: /api/trait.hpp");
+                                  "/api/trait.hpp"
 #endif
-            }
+                );
         }
 
         template <typename T>
         inline jule::Bool type_is(void) const noexcept
         {
-            if (this->operator==(nullptr))
-                return false;
+            return this->type_id() == jule::type_id<T>();
+        }
 
-            return std::strcmp(this->type_id, typeid(T).name()) == 0;
+        // Returns runtime identity of type of data.
+        // Returns nullptr if data is nil.
+        inline jule::TypeId type_id(void) const noexcept
+        {
+            if (this->operator==(nullptr))
+                return nullptr;
+            return this->type;
         }
 
         inline Mask &get(
@@ -136,7 +130,14 @@ namespace jule
 #endif
             );
 #endif
-            return *this->data;
+            return this->__get();
+        }
+
+        // Returns reference to data.
+        // Not includes safety checking.
+        inline Mask &__get(void) const noexcept
+        {
+            return this->data.__get();
         }
 
         ~Trait(void) = default;
@@ -156,16 +157,12 @@ namespace jule
                 file
 #endif
             );
-            if (std::strcmp(this->type_id, typeid(T).name()) != 0)
-            {
+            if (__JULE_UNLIKELY(this->type != jule::type_id<T>()))
+                jule::panic_error(__JULE_ERROR__INCOMPATIBLE_TYPE "\nruntime: trait casted to incompatible type"
 #ifndef __JULE_ENABLE__PRODUCTION
-                std::string error = __JULE_ERROR__INCOMPATIBLE_TYPE "\nruntime: trait casted to incompatible type\nfile: ";
-                error += file;
-                jule::panic(error);
-#else
-                jule::panic(__JULE_ERROR__INCOMPATIBLE_TYPE "\nruntime: trait casted to incompatible type");
+                                  , file
 #endif
-            }
+                );
 #endif
             return *static_cast<T *>(this->data.alloc);
         }
@@ -185,20 +182,17 @@ namespace jule
                 file
 #endif
             );
-            if (std::strcmp(this->type_id, typeid(jule::Ptr<T>).name()) != 0)
-            {
+            if (__JULE_UNLIKELY(this->type != jule::type_id<jule::Ptr<T>>()))
+                jule::panic_error(__JULE_ERROR__INCOMPATIBLE_TYPE "\nruntime: trait casted to incompatible type"
 #ifndef __JULE_ENABLE__PRODUCTION
-                std::string error = __JULE_ERROR__INCOMPATIBLE_TYPE "\nruntime: trait casted to incompatible type\nfile: ";
-                error += file;
-                jule::panic(error);
-#else
-                jule::panic(__JULE_ERROR__INCOMPATIBLE_TYPE "\nruntime: trait casted to incompatible type");
+                                  , file
 #endif
-            }
+                );
 #endif
 
 #ifndef __JULE_DISABLE__REFERENCE_COUNTING
-            this->data.add_ref();
+            if (this->data.ref)
+                this->data.add_ref();
 #endif
             return jule::Ptr<T>::make(static_cast<T *>(this->data.alloc), this->data.ref);
         }
@@ -240,6 +234,18 @@ namespace jule
             return *this;
         }
 
+        inline jule::Trait<Mask>& operator=(jule::Trait<Mask> &&src) noexcept
+        {
+            // Assignment to itself.
+            if (this == &src)
+                return *this;
+
+            this->data = std::move(src.data);
+            this->type = src.type;
+            src.type = nullptr;
+            return *this;
+        }
+
         constexpr jule::Bool operator==(const jule::Trait<Mask> &src) const noexcept
         {
             return this->data.alloc == src.data.alloc;
@@ -8,6 +8,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <ostream>
+#include <type_traits>
 
 #include "platform.hpp"
 
@@ -44,6 +45,28 @@ namespace jule
     constexpr jule::I64 MAX_I64 = 9223372036854775807LL;
     constexpr jule::I64 MIN_I64 = -9223372036854775807 - 1;
     constexpr jule::U64 MAX_U64 = 18446744073709551615LLU;
+
+    // Runtime identity of type.
+    // Address of type descriptor, same types have same identity.
+    typedef const void *TypeId;
+
+    template <typename T>
+    struct TypeDescriptor
+    {
+    public:
+        static const char id;
+    };
+
+    template <typename T>
+    const char TypeDescriptor<T>::id = 0;
+
+    // Returns runtime identity of type.
+    // Identities compared by address instead of type names.
+    template <typename T>
+    constexpr jule::TypeId type_id(void) noexcept
+    {
+        return &jule::TypeDescriptor<typename std::decay<T>::type>::id;
+    }
 } // namespace jule
 
 inline std::ostream &operator<<(std::ostream &stream, const jule::I8 &x)